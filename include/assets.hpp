@@ -0,0 +1,34 @@
+#ifndef ASSETS_HPP
+#define ASSETS_HPP
+
+#include <future>
+#include <map>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* Loads every font once and hands the same handle to each caller. File
+ * contents are read on worker threads, so preloading before SDL_Init
+ * overlaps the disk reads with video startup. */
+class Assets {
+public:
+    Assets(const std::vector<std::string>& _preloadPaths);
+
+    static std::string find_font(const std::vector<std::string>& _candidates);
+
+    void preload(const std::string& _path);
+    TTF_Font* get_font(const std::string& _path, int _ptSize);
+    void shutdown();
+
+private:
+    static std::vector<char> read_file(const std::string& _path);
+    const std::vector<char>& get_file(const std::string& _path);
+
+    std::unordered_map<std::string, std::shared_future<std::vector<char>>> files;
+    std::map<std::pair<std::string, int>, TTF_Font*> fonts;
+};
+
+#endif
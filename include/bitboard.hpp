@@ -0,0 +1,62 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstdint>
+#include "direction.hpp"
+#include <SDL.h>
+#include <vector>
+
+/* One bit per tile, row-major like TileGrid, packed into 64-bit words. Every
+ * operation works a word at a time and in place, so a board query is a few
+ * shifts and masks with no per-tile branching and no allocation. Bits past
+ * the last tile are kept clear. */
+class Bitboard {
+public:
+    Bitboard(int _rows, int _cols);
+
+    int get_rows() const;
+    int get_cols() const;
+
+    bool test(SDL_Point _position) const {
+        const int _index = _position.y * cols + _position.x;
+        return (words[_index / 64] >> (_index % 64) & 1) != 0;
+    }
+
+    void set(SDL_Point _position) {
+        const int _index = _position.y * cols + _position.x;
+        words[_index / 64] |= std::uint64_t{1} << (_index % 64);
+    }
+
+    void reset(SDL_Point _position) {
+        const int _index = _position.y * cols + _position.x;
+        words[_index / 64] &= ~(std::uint64_t{1} << (_index % 64));
+    }
+
+    void clear();
+    void invert();
+    bool any() const;
+    int count() const;
+    bool intersects(const Bitboard& _other) const;
+    Bitboard& operator&=(const Bitboard& _other);
+    Bitboard& operator|=(const Bitboard& _other);
+
+    /* Moves every bit one tile in _direction; bits leaving the board are dropped */
+    void shift(Direction _direction);
+
+    /* Grows every set tile into the 3x3 block around it */
+    void dilate();
+
+private:
+    void shift_left(int _bits);
+    void shift_right(int _bits);
+    void mask_tail();
+
+    int rows;
+    int cols;
+    std::vector<std::uint64_t> words;
+    std::vector<std::uint64_t> notFirstColumn;
+    std::vector<std::uint64_t> notLastColumn;
+    std::vector<std::uint64_t> scratch;
+};
+
+#endif
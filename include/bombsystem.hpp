@@ -0,0 +1,80 @@
+#ifndef BOMBSYSTEM_HPP
+#define BOMBSYSTEM_HPP
+
+#include "bitboard.hpp"
+#include <cstdint>
+#include "direction.hpp"
+#include "motion.hpp"
+#include "slotmap.hpp"
+#include <SDL.h>
+#include <vector>
+
+/* Every thrown bomb: the shared movement components in a MotionTable and
+ * each bomb's fuse alongside, all indexed by bomb. A bomb flies until the
+ * tile ahead is a wall or off the board, then stands still and blasts the
+ * tiles around it for its lifetime. Each bomb has a Handle that survives
+ * being reordered, and a removal moves the last bomb into the gap. */
+class BombSystem {
+public:
+    BombSystem(
+        int _numRows,
+        int _numCols,
+        int _tileSize,
+        SDL_Point _gridOffset
+    );
+
+    size_t size() const;
+    bool empty() const;
+
+    /* Up to _capacity bombs, adding and removing never allocates */
+    void reserve(size_t _capacity);
+
+    void clear();
+    Handle add(SDL_Point _position, double _speed, Direction _direction);
+    void remove(size_t _index);
+    Handle get_handle(size_t _index) const;
+    bool contains(Handle _handle) const;
+    size_t find(Handle _handle) const;
+
+    SDL_Point get_position(size_t _index) const {
+        return motion.get_position(_index);
+    }
+
+    SDL_Rect get_rect(size_t _index) const {
+        return motion.get_rect(_index);
+    }
+
+    SDL_Rect get_prev_rect(size_t _index) const {
+        return motion.get_prev_rect(_index);
+    }
+
+    bool is_exploding(size_t _index) const {
+        return exploding[_index] != 0;
+    }
+
+    double get_lifetime(size_t _index) const {
+        return lifetimes[_index];
+    }
+
+    SDL_Rect get_blast_rect(size_t _index) const;
+
+    /* Replaces _area with the tiles the blast rect reaches */
+    void get_blast_area(size_t _index, Bitboard& _area) const;
+
+    bool hits_wall(size_t _index, const Bitboard& _walls) const;
+
+    /* The blast this tick, with no height on the tick it is lit and once it is spent */
+    SDL_Rect explode(size_t _index, double _dt);
+
+    void move(double _dt);
+    void translate(SDL_Point _delta);
+
+private:
+    int tileSize;
+    SlotIndex keys;
+    MotionTable motion;
+    std::vector<std::uint8_t> exploding;
+    std::vector<double> lifetimes;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include <algorithm>
+#include <SDL.h>
+
+/* A window-sized view onto the scene, in the same pixel coordinates as the
+ * grid and entity rects. Drawing code asks whether a rect is in view before
+ * submitting it and moves it to screen coordinates with to_screen. */
+class Camera {
+public:
+    Camera(SDL_Point _viewSize) :
+        view({0, 0, _viewSize.x, _viewSize.y})
+    {}
+
+    /* Centres the view on _target without showing past the edges of a
+     * scene larger than the view; a smaller scene is centred in the view */
+    void follow(const SDL_Rect& _target, SDL_Point _sceneSize) {
+        view.x = follow_axis(_target.x + _target.w / 2, view.w, _sceneSize.x);
+        view.y = follow_axis(_target.y + _target.h / 2, view.h, _sceneSize.y);
+    }
+
+    const SDL_Rect& get_view() const {
+        return view;
+    }
+
+    bool sees(const SDL_Rect& _rect) const {
+        return _rect.x < view.x + view.w && _rect.x + _rect.w > view.x && _rect.y < view.y + view.h && _rect.y + _rect.h > view.y;
+    }
+
+    SDL_Rect to_screen(const SDL_Rect& _rect) const {
+        return {_rect.x - view.x, _rect.y - view.y, _rect.w, _rect.h};
+    }
+
+    SDL_Point to_screen(SDL_Point _point) const {
+        return {_point.x - view.x, _point.y - view.y};
+    }
+
+private:
+    static int follow_axis(int _centre, int _viewLength, int _sceneLength) {
+        if (_sceneLength <= _viewLength) {
+            return -((_viewLength - _sceneLength) / 2);
+        }
+
+        return std::clamp(_centre - _viewLength / 2, 0, _sceneLength - _viewLength);
+    }
+
+    SDL_Rect view;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef CHUNKCACHE_HPP
+#define CHUNKCACHE_HPP
+
+#include <cstdint>
+#include "level.hpp"
+#include <SDL.h>
+#include "tile.hpp"
+#include <vector>
+
+/* A fixed number of chunk-sized slots filled from a chunked level on demand.
+ * A lookup scans the slots, which is cheap at the couple of dozen chunks
+ * kept around the player, and a miss overwrites the least recently used
+ * slot, so the cache never allocates after construction. */
+class ChunkCache {
+public:
+    ChunkCache(const Level& _level, int _capacity);
+
+    /* chunkSize * chunkSize tiles, valid until the next call to get */
+    const Tile* get(SDL_Point _chunk);
+    void prefetch(SDL_Point _chunk) const;
+    unsigned long get_misses() const;
+
+private:
+    int find(SDL_Point _chunk) const;
+
+    const Level& level;
+    size_t chunkArea;
+    std::vector<Tile> tiles;
+    std::vector<SDL_Point> slotChunks;
+    std::vector<std::uint64_t> slotUses;
+    std::uint64_t useClock;
+    unsigned long misses;
+};
+
+#endif
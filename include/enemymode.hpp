@@ -0,0 +1,9 @@
+#ifndef ENEMYMODE_HPP
+#define ENEMYMODE_HPP
+
+enum class EnemyMode {
+    wander,
+    chase,
+};
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef ENEMYSYSTEM_HPP
+#define ENEMYSYSTEM_HPP
+
+#include "bitboard.hpp"
+#include <cstdint>
+#include "direction.hpp"
+#include "flowfield.hpp"
+#include "grid.hpp"
+#include "motion.hpp"
+#include "random.hpp"
+#include "slotmap.hpp"
+#include "spatialhash.hpp"
+#include <SDL.h>
+#include "threadpool.hpp"
+#include <vector>
+
+/* Every enemy: the shared movement components in a MotionTable and each
+ * enemy's random stream alongside, all indexed by enemy. Only enemies
+ * reaching a new tile branch off from the movement system to choose a
+ * direction.
+ *
+ * The active enemies, those on the board, come first and are the ones
+ * indexed by size(), moved and hit; the dormant ones follow. Each enemy has
+ * a Handle that survives being reordered, woken or put to sleep, and a
+ * removal moves another enemy into the gap instead of shifting the rest.
+ *
+ * With enough active enemies, moving them and the first query after they
+ * move are split into chunks on the thread pool. Every enemy changes only
+ * its own components and random stream, and hits are kept per chunk and
+ * joined in chunk order, so the outcome matches a single thread exactly. */
+class EnemySystem {
+public:
+    EnemySystem(
+        int _numRows,
+        int _numCols,
+        int _tileSize,
+        SDL_Point _gridOffset,
+        ThreadPool& _threadPool
+    );
+
+    size_t size() const;
+    bool empty() const;
+    size_t get_num_dormant() const;
+    void clear();
+    Handle add(SDL_Point _position, double _speed, Direction _direction, Random _random, bool _active);
+    Handle get_handle(size_t _index) const;
+    bool contains(Handle _handle) const;
+    size_t find(Handle _handle) const;
+
+    SDL_Point get_position(size_t _index) const {
+        return motion.get_position(_index);
+    }
+
+    SDL_Point get_next_position(size_t _index) const {
+        return motion.get_next_position(_index);
+    }
+
+    SDL_Rect get_rect(size_t _index) const {
+        return motion.get_rect(_index);
+    }
+
+    SDL_Rect get_prev_rect(size_t _index) const {
+        return motion.get_prev_rect(_index);
+    }
+
+    void move(const Grid& _grid, const FlowField* _flowField, double _dt);
+
+    /* Replaces _hits with the ascending indices of the active enemies overlapping _rect */
+    void find_hits(const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits);
+
+    /* The tiles the active enemies' rects reach: each one's tile and the
+     * one it walks toward. Built at most once per move; removals leave it a
+     * superset, which is all a broadphase needs. */
+    const Bitboard& get_occupancy();
+
+    /* Takes ascending indices, as find_hits leaves them */
+    void remove(const std::vector<std::uint32_t>& _indices);
+
+    void translate(SDL_Point _delta);
+
+    /* Wakes the dormant enemies now on the board and parks the active ones that left it */
+    void update_activity(const Grid& _grid);
+
+private:
+    void move_range(size_t _first, size_t _last, const Grid& _grid, const FlowField* _flowField, double _dt);
+    void scan_chunks(const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits);
+    void set_direction(size_t _index, const Grid& _grid, const FlowField* _flowField);
+    void swap_elements(size_t _first, size_t _second);
+    void pop_back();
+
+    int tileSize;
+    size_t numActive;
+    SlotIndex keys;
+    MotionTable motion;
+    std::vector<Random> randoms;
+    SpatialHash cells;
+    int queriesSinceChange;
+    Bitboard occupancy;
+    bool occupancyValid;
+    ThreadPool& threadPool;
+    std::vector<std::vector<std::uint32_t>> chunkHits;
+};
+
+#endif
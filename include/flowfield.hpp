@@ -0,0 +1,34 @@
+#ifndef FLOWFIELD_HPP
+#define FLOWFIELD_HPP
+
+#include "direction.hpp"
+#include "grid.hpp"
+#include <SDL.h>
+#include <vector>
+
+/* The first step of a shortest path to one target tile, for every tile of
+ * the board. One breadth-first search from the target serves any number of
+ * chasers, each of which then looks up its next direction in constant time.
+ * The search only reruns when the target changes tile or the walls change. */
+class FlowField {
+public:
+    FlowField(int _rows, int _cols);
+
+    void update(const Grid& _grid, SDL_Point _target);
+
+    /* Direction::none at the target and on tiles that cannot reach it */
+    Direction get_direction(SDL_Point _position) const {
+        return directions[_position.y * cols + _position.x];
+    }
+
+private:
+    int rows;
+    int cols;
+    std::vector<Direction> directions;
+    std::vector<int> distances;
+    std::vector<int> frontier;
+    SDL_Point target;
+    unsigned int layoutVersion;
+};
+
+#endif
@@ -2,42 +2,55 @@
 #define FPSCOUNTER_HPP
 
 #include "highest_resolution_steady_clock.hpp"
+#include "histogram.hpp"
+#include <array>
 #include <SDL.h>
-#include <SDL_ttf.h>
-
-struct TextureRect;
+#include <string>
+#include "textrenderer.hpp"
+#include <vector>
 
 class FPSCounter {
 public:
+    enum class Phase {
+        poll,
+        step,
+        draw,
+        present,
+    };
+
     FPSCounter(
         SDL_Window* _window,
-        SDL_Renderer* _renderer
+        SDL_Renderer* _renderer,
+        const TextRenderer* _textRenderer
     );
 
     void draw();
-    void shutdown();
+    void record_phase(Phase _phase, std::chrono::nanoseconds _duration);
+    void toggle_overlay();
+    void dump(const char* _path) const;
 
 private:
-    struct TextureRect {
-        SDL_Texture* texture;
-        SDL_Rect rect;
-        
-        TextureRect(SDL_Texture* _texture, SDL_Rect _rect) : texture(_texture), rect(_rect) {}
-    };
-    
-    TTF_Font* init_font(const char* _fontPath, int _fontPtSize);
-    
-    TextureRect set_textureRect(const char* _fpsText);
-    
+    int init_window_width() const;
+    void update_overlay();
+    static std::string format_series(const char* _name, const Histogram& _histogram);
+
+    static constexpr int phaseCount = 4;
+    static constexpr std::array<const char*, phaseCount> phaseNames{"poll", "step", "draw", "present"};
+
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Color textColor;
-    TTF_Font* font;
-    TextureRect textureRect;
+    const TextRenderer* textRenderer;
+    int windowWidth;
+    TextRenderer::Label label;
     std::chrono::time_point<highest_resolution_steady_clock> prevTime;
     bool prevTimeValid;
     double updateRate;
     int frameCount;
+    std::chrono::time_point<highest_resolution_steady_clock> prevFrameTime;
+    Histogram frameHistogram;
+    std::array<Histogram, phaseCount> phaseHistograms;
+    bool overlayOn;
+    std::vector<TextRenderer::Label> overlayLabels;
 };
 
 #endif
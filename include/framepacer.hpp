@@ -0,0 +1,49 @@
+#ifndef FRAMEPACER_HPP
+#define FRAMEPACER_HPP
+
+#include "highest_resolution_steady_clock.hpp"
+#include <SDL.h>
+
+class FramePacer {
+public:
+    enum class Mode {
+        vsync,
+        capped,
+        uncapped,
+        adaptive,
+    };
+
+    FramePacer(
+        SDL_Renderer* _renderer,
+        Mode _mode,
+        double _targetRate
+    );
+
+    void set_mode(Mode _mode);
+    void wait();
+
+    /* Logs how far frame intervals strayed from the target in the current mode */
+    void log_error() const;
+
+private:
+    void set_vsync(bool _vsyncOn);
+    void sleep_until(std::chrono::time_point<highest_resolution_steady_clock> _deadline);
+    void track_error(std::chrono::time_point<highest_resolution_steady_clock> _currTime);
+    static const char* mode_name(Mode _mode);
+
+    SDL_Renderer* renderer;
+    Mode mode;
+    double targetRate;
+    std::chrono::nanoseconds period;
+    bool vsyncOn;
+    std::chrono::time_point<highest_resolution_steady_clock> deadline;
+    std::chrono::time_point<highest_resolution_steady_clock> prevTime;
+    bool prevTimeValid;
+    std::chrono::nanoseconds spinThreshold;
+    int missedFrames;
+    int metFrames;
+    double meanError;
+    double maxError;
+};
+
+#endif
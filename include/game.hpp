@@ -1,11 +1,21 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
-#include "enemy.hpp"
+#include "bitboard.hpp"
+#include "bombsystem.hpp"
+#include "camera.hpp"
+#include "enemymode.hpp"
+#include "enemysystem.hpp"
+#include "flowfield.hpp"
 #include "keyboard.hpp"
 #include "grid.hpp"
+#include "level.hpp"
 #include "player.hpp"
+#include "random.hpp"
 #include "hud.hpp"
+#include "snapshot.hpp"
+#include "threadpool.hpp"
+#include <cstdint>
 #include <SDL.h>
 
 enum class State;
@@ -14,13 +24,25 @@ class Game {
 public:
     Game(
         SDL_Window* _window,
-        SDL_Renderer* _renderer
+        SDL_Renderer* _renderer,
+        const TextRenderer* _textRenderer,
+        const Level& _level,
+        EnemyMode _enemyMode,
+        int _maxBombs,
+        ThreadPool& _threadPool,
+        std::uint64_t _seed
     );
     
     bool gameOn() const;
-    void poll();
-    void step();
-    void draw();
+    bool roundOver() const;
+    int get_level() const;
+    unsigned long get_chunk_misses() const;
+    void handle_event(const SDL_Event& _event);
+    void step(double _dt);
+    void snapshot(RenderSnapshot& _snapshot) const;
+    void draw(const RenderSnapshot& _snapshot, double _alpha);
+    void invalidate_render_cache();
+    void shutdown();
 
 private:
     enum class State {
@@ -30,17 +52,36 @@ private:
         gameOver,
     };
 
+    SDL_Point calc_view_size() const;
+    void spawn_enemies();
+    void follow_player();
+
     SDL_Window* window;
     SDL_Renderer* renderer;
     State state;
     Keyboard keyboard;
-    int numRows;
-    int numCols;
+    const Level& level;
     int tileSize;
+    Random random;
     Grid grid;
+    int numRows;
+    int numCols;
+    EnemyMode enemyMode;
+    FlowField flowField;
     Player player;
-    std::vector<Enemy> enemies;
+    BombSystem bombs;
+    EnemySystem enemies;
+    std::vector<std::uint32_t> enemyHits;
+    Bitboard blastArea;
     HUD hud;
+    Camera camera;
+    double gameOverTime;
+    double gameOverDelay;
+    size_t maxBombs;
+    double bombInterval;
+    double bombCooldown;
+    unsigned int flashCount;
+    unsigned int drawnFlashCount;
 };
 
 #endif
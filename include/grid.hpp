@@ -1,8 +1,19 @@
 #ifndef GRID_HPP
 #define GRID_HPP
 
+#include <array>
+#include "bitboard.hpp"
+#include "camera.hpp"
+#include "chunkcache.hpp"
+#include <cstdint>
+#include "direction.hpp"
+#include "level.hpp"
+#include <memory>
+#include "random.hpp"
 #include <SDL.h>
+#include "snapshot.hpp"
 #include "tile.hpp"
+#include "tilegrid.hpp"
 #include <vector>
 
 class Grid {
@@ -10,43 +21,92 @@ public:
     Grid(
         SDL_Window* _window,
         SDL_Renderer* _renderer,
-        int _numRows,
-        int _numCols,
-        int _tileSize
+        const Level& _level,
+        int _tileSize,
+        Random _random
     );
 
-    std::vector<std::vector<Tile>> init_grid();
+    TileGrid init_grid() const;
     SDL_Point init_fruit();
+    int get_rows() const;
+    int get_cols() const;
+    bool contains(SDL_Point _position) const;
+    SDL_Point to_board(SDL_Point _world) const;
     SDL_Point get_grid_size() const;
     SDL_Point get_scene_size() const;
-    SDL_Point get_scene_offset() const;
     SDL_Point get_grid_offset() const;
+    SDL_Point get_fruit_pos() const;
+    const Bitboard& get_walls() const;
+    const Bitboard& get_fruits() const;
+    const Bitboard& get_players() const;
+
+    /* Bit 1 << Direction is set for each direction that does not lead into a wall */
+    unsigned int get_legal_moves(SDL_Point _position) const {
+        return legalMoves[_position.y * numCols + _position.x];
+    }
+
+    std::shared_ptr<const TileGrid> get_layout() const;
+    unsigned int get_layout_version() const;
+    unsigned long get_chunk_misses() const;
     int update(SDL_Point _prevPos, SDL_Point _currPos);
-    void draw_grid();
-    void draw_walls();
-    void draw_tile(const SDL_Point& tilePosition, const Tile& tileType);
+    SDL_Point follow(SDL_Point _playerPos, Direction _direction);
+    void draw_grid(const RenderSnapshot& _snapshot, const Camera& _camera);
+    void draw_walls(const Camera& _camera);
+    void draw_tile(const SDL_Point& tilePosition, const Tile& tileType, const Camera& _camera);
+    void invalidate_static_layer();
     void reset();
-    
-    std::vector<std::vector<Tile>> grid;
+    void shutdown();
 
 private:
     SDL_Point calc_grid_size() const;
     SDL_Point calc_scene_size() const;
-    SDL_Point calc_scene_offset() const;
     SDL_Point calc_grid_offset() const;
     std::vector<SDL_Rect> calc_wall_rects() const;
+    static SDL_Point calc_board_chunks(const Level& _level);
+    SDL_Point calc_origin(SDL_Point _focus) const;
+    void load_tiles(SDL_Point _origin);
+    void prefetch_ahead(Direction _direction);
+    void refresh_layout();
+    void index_tiles();
+    void update_open_neighbours();
+    void update_open_neighbours(SDL_Point _position);
+    void update_legal_moves(const SDL_Rect& _area);
+    Bitboard* get_board(Tile _tile);
+    void set_tile(SDL_Point _position, Tile _tile);
+    SDL_Texture* init_static_layer();
+    void draw_static_layer(const TileGrid& _layout, SDL_Point _origin, const SDL_Rect& _tiles);
     
     SDL_Window* window;
     SDL_Renderer* renderer;
+    const Level& level;
     const int numRows;
     const int numCols;
     int tileSize;
+    Random random;
+    ChunkCache chunks;
+    SDL_Point origin;
+    Direction prefetchDirection;
+    SDL_Point prefetchOrigin;
     SDL_Point gridSize;
     SDL_Point sceneSize;
-    SDL_Point sceneOffset;
     SDL_Point gridOffset;
+    TileGrid grid;
     std::vector<SDL_Rect> wallRects;
+    std::vector<int> emptyTiles;
+    std::vector<int> emptySlots;
+    Bitboard walls;
+    Bitboard fruits;
+    Bitboard players;
+    std::array<Bitboard, 4> openNeighbours;
+    std::vector<std::uint8_t> legalMoves;
     SDL_Point fruitPos;
+    std::shared_ptr<const TileGrid> layout;
+    unsigned int layoutVersion;
+    bool staticLayerSupported;
+    SDL_Texture* staticLayer;
+    bool staticLayerValid;
+    unsigned int staticLayerVersion;
+    std::vector<SDL_Rect> staticWallRects;
 };
 
 #endif
@@ -0,0 +1,37 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/* Log-bucketed histogram of durations in nanoseconds. Each power of two is
+ * split into 16 linear sub-buckets, so any recorded value is reported
+ * within about 3% without storing samples. Recording and reading may
+ * happen on different threads. */
+class Histogram {
+public:
+    Histogram();
+
+    void record(std::int64_t _ns);
+    void reset();
+    std::uint64_t get_count() const;
+    std::int64_t get_max() const;
+    double get_mean() const;
+    std::int64_t get_percentile(double _percentile) const;
+
+private:
+    static constexpr int subBucketBits = 4;
+    static constexpr int subBucketCount = 1 << subBucketBits;
+    static constexpr int bucketCount = subBucketCount + (64 - subBucketBits) * subBucketCount;
+
+    static int bucket_index(std::uint64_t _value);
+    static std::uint64_t bucket_midpoint(int _index);
+
+    std::array<std::atomic<std::uint64_t>, bucketCount> buckets;
+    std::atomic<std::uint64_t> count;
+    std::atomic<std::int64_t> max;
+    std::atomic<std::int64_t> sum;
+};
+
+#endif
@@ -1,39 +1,31 @@
 #ifndef HUD_HPP
 #define HUD_HPP
 
-#include "highest_resolution_steady_clock.hpp"
 #include <SDL.h>
-#include <SDL_ttf.h>
-
-struct TextureRect;
+#include <string>
+#include <string_view>
+#include "textrenderer.hpp"
 
 class HUD {
 public:
     HUD(
         SDL_Window* _window,
-        SDL_Renderer* _renderer
+        SDL_Renderer* _renderer,
+        const TextRenderer* _textRenderer,
+        std::string_view _levelName
     );
 
-    void draw();
-    void shutdown();
+    void draw(int _level);
     void increment_level();
+    int get_level() const;
 
 private:
-    struct TextureRect {
-        SDL_Texture* texture;
-        SDL_Rect rect;
-        
-        TextureRect(SDL_Texture* _texture, SDL_Rect _rect) : texture(_texture), rect(_rect) {}
-    };
-
-    TTF_Font* init_font(const char* _fontPath, int _fontPtSize);
-    TextureRect set_textureRect(const char* _levelText);
-
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Color textColor;
-    TTF_Font* font;
-    TextureRect textureRect;
+    const TextRenderer* textRenderer;
+    TextRenderer::Label label;
+    std::string levelName;
+    int drawnLevel;
     int level;
 };
 
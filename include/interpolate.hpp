@@ -0,0 +1,17 @@
+#ifndef INTERPOLATE_HPP
+#define INTERPOLATE_HPP
+
+#include <cmath>
+#include <SDL.h>
+
+/* Blend between the rects of the last two simulation ticks for rendering */
+inline SDL_Rect interpolate_rect(const SDL_Rect& _prevRect, const SDL_Rect& _currRect, double _alpha) {
+    return {
+        static_cast<int>(std::lround(_prevRect.x + (_currRect.x - _prevRect.x) * _alpha)),
+        static_cast<int>(std::lround(_prevRect.y + (_currRect.y - _prevRect.y) * _alpha)),
+        _currRect.w,
+        _currRect.h
+    };
+}
+
+#endif
@@ -9,7 +9,7 @@ public:
     Keyboard();
     
     bool get_key(SDL_Keycode _key) const;
-    void set_key(SDL_Event* _event);
+    void set_key(const SDL_Event* _event);
     void reset();
     
 private:
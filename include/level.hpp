@@ -0,0 +1,88 @@
+#ifndef LEVEL_HPP
+#define LEVEL_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <SDL.h>
+#include <string>
+#include <string_view>
+#include "tile.hpp"
+
+/* A level file is a LevelHeader, then numEnemySpawns LevelSpawns, then the
+ * tiles. Every field is little-endian and naturally aligned, so a mapped
+ * file is read in place through these structs with no parsing step. Speeds
+ * are in tiles per second.
+ *
+ * With chunkSize 0 the tiles are rows * cols bytes in TileGrid order. Large
+ * levels set chunkSize instead, which must divide rows and cols, and store
+ * chunkSize x chunkSize blocks, each row-major, with the blocks themselves
+ * in row-major order. */
+struct LevelSpawn {
+    std::uint32_t x;
+    std::uint32_t y;
+};
+
+struct LevelHeader {
+    char magic[4];
+    std::uint16_t version;
+    std::uint16_t chunkSize;
+    std::uint32_t rows;
+    std::uint32_t cols;
+    std::uint32_t numEnemySpawns;
+    LevelSpawn playerSpawn;
+    float playerSpeed;
+    float enemySpeed;
+    float bombSpeed;
+    char name[32];
+};
+
+static_assert(sizeof(LevelHeader) == 72 && alignof(LevelHeader) == 4);
+static_assert(std::endian::native == std::endian::little, "Level files are read in place as little-endian");
+
+/* A read-only view of one level. The default level is compiled into the
+ * binary; others are memory-mapped, so opening one costs a few system calls
+ * and the pages are only read as the grid copies its tiles. A chunked level
+ * only maps its header and spawns, and its chunks are read one at a time. */
+class Level {
+public:
+    Level();
+    Level(const std::string& _path);
+    Level(const Level&) = delete;
+    Level& operator=(const Level&) = delete;
+    ~Level();
+
+    /* Writes the binary form of a text level; see levels/default.txt */
+    static void convert(const std::string& _textPath, const std::string& _levelPath);
+
+    std::string_view get_name() const;
+    int get_rows() const;
+    int get_cols() const;
+    const Tile* get_tiles() const;
+    SDL_Point get_player_spawn() const;
+    double get_player_speed() const;
+    int get_num_enemy_spawns() const;
+    SDL_Point get_enemy_spawn(int _index) const;
+    double get_enemy_speed() const;
+    double get_bomb_speed() const;
+
+    /* 0 for a level whose tiles are all in get_tiles() */
+    int get_chunk_size() const;
+    SDL_Point get_num_chunks() const;
+    void read_chunk(SDL_Point _chunk, Tile* _tiles) const;
+    void prefetch_chunk(SDL_Point _chunk) const;
+
+private:
+    void init_view(const char* _source);
+    size_t get_chunk_offset(SDL_Point _chunk) const;
+
+    const unsigned char* bytes;
+    size_t mappedSize;
+    size_t fileSize;
+    int file;
+    const LevelHeader* header;
+    const LevelSpawn* enemySpawns;
+    const Tile* tiles;
+};
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef MOTION_HPP
+#define MOTION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "direction.hpp"
+#include <SDL.h>
+#include <vector>
+
+/* What a walker does once it has covered a whole tile: stop on the new tile
+ * (enemies, who then choose a direction) or carry the remainder on (the
+ * player and bombs) */
+enum class Arrival {
+    stop,
+    carry,
+};
+
+/* The movement and render components shared by everything that walks the
+ * grid, stored column by column for one archetype of entities. Each entity
+ * is on a tile, facing a direction, some distance (offset) into the step
+ * toward the next tile; its rect is where it is drawn and hit this tick and
+ * its previous rect where it was last tick.
+ *
+ * integrate() is the one movement system: it advances a range of entities
+ * in flat loops over the columns and records for each whether it reached
+ * the board's edge or a new tile, for the owner to act on. Owners keep any further
+ * components in columns of their own and reorder them alongside with swap
+ * and pop_back. */
+class MotionTable {
+public:
+    static constexpr std::uint8_t reachedEdge = 1;
+    static constexpr std::uint8_t reachedTile = 2;
+
+    /* Tiles moved along each axis per step in a Direction */
+    static constexpr int stepX[] = {0, 0, 0, -1, 1};
+    static constexpr int stepY[] = {0, -1, 1, 0, 0};
+
+    MotionTable(
+        int _numRows,
+        int _numCols,
+        int _tileSize,
+        SDL_Point _gridOffset
+    );
+
+    size_t size() const {
+        return xs.size();
+    }
+
+    void reserve(size_t _capacity);
+    void add(SDL_Point _position, double _offset, double _speed, Direction _direction);
+    void swap(size_t _first, size_t _second);
+    void pop_back();
+    void clear();
+
+    SDL_Point get_position(size_t _index) const {
+        return {xs[_index], ys[_index]};
+    }
+
+    /* The tile being walked toward, kept on the board */
+    SDL_Point get_next_position(size_t _index) const {
+        const int _direction = static_cast<int>(directions[_index]);
+        return {
+            std::clamp(xs[_index] + stepX[_direction], 0, numCols - 1),
+            std::clamp(ys[_index] + stepY[_direction], 0, numRows - 1)
+        };
+    }
+
+    Direction get_direction(size_t _index) const {
+        return directions[_index];
+    }
+
+    SDL_Rect get_rect(size_t _index) const {
+        return {rectXs[_index], rectYs[_index], tileSize, tileSize};
+    }
+
+    SDL_Rect get_prev_rect(size_t _index) const {
+        return {prevXs[_index], prevYs[_index], tileSize, tileSize};
+    }
+
+    std::uint8_t get_events(size_t _index) const {
+        return events[_index];
+    }
+
+    const std::vector<int>& get_rect_xs() const {
+        return rectXs;
+    }
+
+    const std::vector<int>& get_rect_ys() const {
+        return rectYs;
+    }
+
+    void set_position(size_t _index, SDL_Point _position);
+    void set_offset(size_t _index, double _offset);
+    void set_direction(size_t _index, Direction _direction);
+    void set_speed(size_t _index, double _speed);
+
+    /* Turns around mid-step, walking back from the tile it was heading to.
+     * The rect is left as it was drawn until the next integrate(), which
+     * keeps it as the previous rect. */
+    void reverse(size_t _index, Direction _direction);
+
+    void integrate(size_t _first, size_t _last, double _dt, Arrival _arrival);
+
+    void translate(SDL_Point _delta);
+
+private:
+    void update_rect(size_t _index);
+
+    int numRows;
+    int numCols;
+    int tileSize;
+    SDL_Point gridOffset;
+    std::vector<int> xs;
+    std::vector<int> ys;
+    std::vector<double> offsets;
+    std::vector<double> speeds;
+    std::vector<Direction> directions;
+    std::vector<int> rectXs;
+    std::vector<int> rectYs;
+    std::vector<int> prevXs;
+    std::vector<int> prevYs;
+    std::vector<std::uint8_t> events;
+};
+
+/* Advances every entity in two passes: a branch-free one that moves along
+ * and stops at the board's edge, then one that finishes the few entities
+ * that covered a whole tile and recomputes the rects, keeping the old ones
+ * as the previous rects. Defined here so the player's and the bombs' short
+ * calls inline. The columns and sizes are read into locals, so stores to
+ * one column do not force the others to be reloaded. */
+inline void MotionTable::integrate(size_t _first, size_t _last, double _dt, Arrival _arrival) {
+    const int _tileSize = tileSize;
+    const int _lastColumn = numCols - 1;
+    const int _lastRow = numRows - 1;
+    const SDL_Point _gridOffset = gridOffset;
+    int* const _xs = xs.data();
+    int* const _ys = ys.data();
+    double* const _offsets = offsets.data();
+    const double* const _speeds = speeds.data();
+    const Direction* const _directions = directions.data();
+    std::uint8_t* const _events = events.data();
+    for (size_t i = _first; i < _last; ++i) {
+        const int _stepX = stepX[static_cast<int>(_directions[i])];
+        const int _stepY = stepY[static_cast<int>(_directions[i])];
+        const double _offset = _offsets[i] + _speeds[i] * _dt;
+        const int _tiles = static_cast<int>(_offset) / _tileSize;
+        const int _column = std::clamp(_xs[i] + _stepX * _tiles, 0, _lastColumn);
+        const int _row = std::clamp(_ys[i] + _stepY * _tiles, 0, _lastRow);
+
+        /* At the edge when one more step would leave the board */
+        const bool _atEdge = (static_cast<unsigned int>(_column + _stepX) > static_cast<unsigned int>(_lastColumn)) | (static_cast<unsigned int>(_row + _stepY) > static_cast<unsigned int>(_lastRow));
+        _xs[i] = _column;
+        _ys[i] = _row;
+        _offsets[i] = _atEdge ? 0.0 : _offset;
+        _events[i] = _atEdge ? reachedEdge : 0;
+    }
+
+    int* const _rectXs = rectXs.data();
+    int* const _rectYs = rectYs.data();
+    int* const _prevXs = prevXs.data();
+    int* const _prevYs = prevYs.data();
+    for (size_t i = _first; i < _last; ++i) {
+        if (_offsets[i] >= _tileSize) {
+            _offsets[i] = _arrival == Arrival::stop ? 0.0 : std::fmod(_offsets[i], _tileSize);
+            _events[i] = reachedTile;
+        }
+        const int _offset = static_cast<int>(_offsets[i]);
+        _prevXs[i] = _rectXs[i];
+        _prevYs[i] = _rectYs[i];
+        _rectXs[i] = _gridOffset.x + _tileSize * _xs[i] + stepX[static_cast<int>(_directions[i])] * _offset;
+        _rectYs[i] = _gridOffset.y + _tileSize * _ys[i] + stepY[static_cast<int>(_directions[i])] * _offset;
+    }
+}
+
+#endif
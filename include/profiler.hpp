@@ -0,0 +1,83 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+/* Hot-path instrumentation. Zones and counters are recorded into per-thread
+ * ring buffers and exported as Chrome trace-event JSON (chrome://tracing,
+ * Perfetto). Everything compiles away unless PROFILER_ENABLED is defined. */
+
+#ifdef PROFILER_ENABLED
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Profiler {
+public:
+    class Zone {
+    public:
+        Zone(const char* _name);
+        ~Zone();
+
+    private:
+        const char* name;
+        std::int64_t start;
+    };
+
+    static void counter(const char* _name, std::int64_t _value);
+    static void export_trace(const char* _path);
+
+private:
+    struct Event {
+        const char* name;
+        std::int64_t start;
+        std::int64_t duration;
+        std::int64_t value;
+        bool isCounter;
+    };
+
+    static constexpr std::size_t bufferCapacity = 1 << 16;
+
+    /* An event with a sequence number, odd while the owner is writing it and
+     * 2 * (position + 1) once written, so an exporter copying it from another
+     * thread can tell a torn or overwritten copy and drop it */
+    struct Slot {
+        std::atomic<std::uint64_t> sequence;
+        std::atomic<const char*> name;
+        std::atomic<std::int64_t> start;
+        std::atomic<std::int64_t> duration;
+        std::atomic<std::int64_t> value;
+        std::atomic<bool> isCounter;
+    };
+
+    struct ThreadBuffer {
+        std::array<Slot, bufferCapacity> slots;
+        std::atomic<std::uint64_t> head;
+        int threadId;
+    };
+
+    static ThreadBuffer& thread_buffer();
+    static void push(const Event& _event);
+    static std::int64_t now();
+
+    static std::mutex registryMutex;
+    static std::vector<std::shared_ptr<ThreadBuffer>> registry;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_CONCAT(_profileZone, __LINE__)(name)
+#define PROFILE_COUNTER(name, value) Profiler::counter(name, value)
+#define PROFILE_EXPORT(path) Profiler::export_trace(path)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#define PROFILE_EXPORT(path) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+/* xoshiro256** seeded through splitmix64. It is fast and reproducible, not
+ * secure, so it is only for gameplay decisions. Systems and entities each
+ * own a stream forked from the game's, so a new consumer of random numbers
+ * does not shift what the others draw. */
+class Random {
+public:
+    Random(std::uint64_t _seed, std::uint64_t _stream = 0) :
+        state()
+    {
+        std::uint64_t _mix = _seed ^ (_stream * 0xD1B54A32D192ED03ull);
+        for (auto& _word : state) {
+            _word = splitmix(_mix);
+        }
+    }
+
+    std::uint64_t next() {
+        const std::uint64_t _result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t _t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= _t;
+        state[3] = rotl(state[3], 45);
+
+        return _result;
+    }
+
+    /* Uniform in [0, _bound) without modulo bias (Lemire's multiply-shift) */
+    std::uint32_t below(std::uint32_t _bound) {
+        std::uint64_t _product = (next() >> 32) * _bound;
+        std::uint32_t _low = static_cast<std::uint32_t>(_product);
+        if (_low < _bound) {
+            const std::uint32_t _threshold = -_bound % _bound;
+            while (_low < _threshold) {
+                _product = (next() >> 32) * _bound;
+                _low = static_cast<std::uint32_t>(_product);
+            }
+        }
+
+        return static_cast<std::uint32_t>(_product >> 32);
+    }
+
+    Random fork() {
+        return Random(next());
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t _x, int _k) {
+        return (_x << _k) | (_x >> (64 - _k));
+    }
+
+    static std::uint64_t splitmix(std::uint64_t& _x) {
+        std::uint64_t _z = (_x += 0x9E3779B97F4A7C15ull);
+        _z = (_z ^ (_z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        _z = (_z ^ (_z >> 27)) * 0x94D049BB133111EBull;
+        return _z ^ (_z >> 31);
+    }
+
+    std::uint64_t state[4];
+};
+
+#endif
@@ -1,14 +1,27 @@
 #ifndef SCENE_HPP
 #define SCENE_HPP
 
+#include "assets.hpp"
+#include "enemymode.hpp"
 #include "fpscounter.hpp"
+#include "framepacer.hpp"
 #include "game.hpp"
 #include "highest_resolution_steady_clock.hpp"
+#include "level.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <SDL.h>
+#include "snapshot.hpp"
+#include <string>
+#include "textrenderer.hpp"
+#include "threadpool.hpp"
+#include "triplebuffer.hpp"
+#include <vector>
 
 class Scene {
 public:
-    Scene();
+    Scene(const char* _statsPath, const char* _tracePath, const Level& _level, EnemyMode _enemyMode, int _maxBombs, int _numThreads, std::uint64_t _seed);
     ~Scene();
     void run();
 
@@ -16,19 +29,29 @@ private:
     SDL_Window* init_window();
     SDL_Renderer* init_renderer();
 
+    void simulate();
+    void poll();
     void clear_frame();
     void display_frame();
-    void delay_frame();
 
     const char* windowName;
-    bool vsyncOn;
+    const char* statsPath;
+    const char* tracePath;
+    std::string fontPath;
+    Assets assets;
     SDL_Window* window;
     SDL_Renderer* renderer;
-    std::chrono::time_point<highest_resolution_steady_clock> prevTime;
-    bool prevTimeValid;
-    double maxRefreshRate;
+    FramePacer framePacer;
+    double tickRate;
+    double maxFrameTime;
+    TextRenderer textRenderer;
     FPSCounter fpsCounter;
+    ThreadPool threadPool;
     Game game;
+    std::atomic<bool> running;
+    std::mutex inputMutex;
+    std::vector<SDL_Event> inputQueue;
+    TripleBuffer<RenderSnapshot> snapshots;
 };
 
 #endif
@@ -0,0 +1,49 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <cstdint>
+#include "enemymode.hpp"
+#include "level.hpp"
+#include <SDL.h>
+#include "threadpool.hpp"
+#include <vector>
+
+class Simulation {
+public:
+    Simulation(
+        int _numGames,
+        long _maxTicks,
+        double _tickRate,
+        const char* _scriptPath,
+        const Level& _level,
+        EnemyMode _enemyMode,
+        int _maxBombs,
+        int _numThreads,
+        std::uint64_t _seed
+    );
+
+    void run();
+
+private:
+    struct ScriptedEvent {
+        long tick;
+        SDL_Keycode key;
+        bool pressed;
+    };
+
+    std::vector<ScriptedEvent> init_script(const char* _scriptPath) const;
+    SDL_Event make_event(const ScriptedEvent& _scriptedEvent) const;
+
+    int numGames;
+    long maxTicks;
+    double tickRate;
+    const Level& level;
+    EnemyMode enemyMode;
+    int maxBombs;
+    ThreadPool threadPool;
+    std::uint64_t seed;
+    std::vector<ScriptedEvent> script;
+    long scriptLength;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SLOTMAP_HPP
+#define SLOTMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/* Names one element of a SlotIndex for as long as it lives. Once
+ * the element is removed its slot's generation moves on, so an old handle
+ * is recognised as stale even after the slot is reused. */
+struct Handle {
+    std::uint32_t slot;
+    std::uint32_t generation;
+};
+
+/* Stable handles for elements kept densely in one or more arrays owned by
+ * the caller. Elements are only ever added at the back, removed from the
+ * back and swapped; the caller does the same to its arrays, which keeps
+ * iteration a plain loop and makes removal a swap with the last element. */
+class SlotIndex {
+public:
+    size_t size() const {
+        return denseSlots.size();
+    }
+
+    void reserve(size_t _capacity) {
+        slotDense.reserve(_capacity);
+        generations.reserve(_capacity);
+        denseSlots.reserve(_capacity);
+        freeSlots.reserve(_capacity);
+    }
+
+    /* Handle for a new element at the back */
+    Handle push() {
+        std::uint32_t _slot;
+        if (freeSlots.empty()) {
+            _slot = static_cast<std::uint32_t>(slotDense.size());
+            slotDense.push_back(0);
+            generations.push_back(0);
+        } else {
+            _slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        slotDense[_slot] = static_cast<std::uint32_t>(denseSlots.size());
+        denseSlots.push_back(_slot);
+
+        return {_slot, generations[_slot]};
+    }
+
+    /* Retires the back element's handle */
+    void pop() {
+        const std::uint32_t _slot = denseSlots.back();
+        denseSlots.pop_back();
+        ++generations[_slot];
+        freeSlots.push_back(_slot);
+    }
+
+    void swap(size_t _first, size_t _second) {
+        std::swap(denseSlots[_first], denseSlots[_second]);
+        slotDense[denseSlots[_first]] = static_cast<std::uint32_t>(_first);
+        slotDense[denseSlots[_second]] = static_cast<std::uint32_t>(_second);
+    }
+
+    void clear() {
+        while (!denseSlots.empty()) {
+            pop();
+        }
+    }
+
+    Handle get_handle(size_t _index) const {
+        return {denseSlots[_index], generations[denseSlots[_index]]};
+    }
+
+    bool contains(Handle _handle) const {
+        return _handle.slot < generations.size() && generations[_handle.slot] == _handle.generation;
+    }
+
+    /* The element's current index; _handle must be contained */
+    size_t find(Handle _handle) const {
+        return slotDense[_handle.slot];
+    }
+
+private:
+    std::vector<std::uint32_t> slotDense;
+    std::vector<std::uint32_t> generations;
+    std::vector<std::uint32_t> denseSlots;
+    std::vector<std::uint32_t> freeSlots;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "highest_resolution_steady_clock.hpp"
+#include <memory>
+#include <SDL.h>
+#include "tilegrid.hpp"
+#include <vector>
+
+/* Everything the render thread needs to draw one simulation tick */
+struct RenderSnapshot {
+    struct Sprite {
+        SDL_Rect prevRect;
+        SDL_Rect currRect;
+        SDL_Color color;
+    };
+
+    std::vector<Sprite> sprites;
+    /* Index of the sprite the camera follows */
+    size_t focus;
+    std::vector<SDL_Rect> explosions;
+    std::shared_ptr<const TileGrid> layout;
+    unsigned int layoutVersion;
+    SDL_Point fruitPos;
+    unsigned int flashCount;
+    int level;
+    std::chrono::time_point<highest_resolution_steady_clock> tickTime;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef SPATIALHASH_HPP
+#define SPATIALHASH_HPP
+
+#include <cstdint>
+#include <SDL.h>
+#include <span>
+#include <vector>
+
+/* A broadphase over tile-sized entities, bucketed by the square of tiles
+ * their top-left corner lies in. build() counting-sorts the entities by
+ * cell, so every cell is one contiguous run of positions and a row of cells
+ * is one run too; a query only tests the runs its rect reaches. Positions
+ * are in pixels, as in the entities' rects. */
+class SpatialHash {
+public:
+    SpatialHash(int _rows, int _cols, int _tileSize, SDL_Point _gridOffset);
+
+    void build(std::span<const int> _xs, std::span<const int> _ys);
+
+    /* Replaces _hits with the ascending indices of the entities overlapping _rect */
+    void query(const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits) const;
+
+    /* The same answer from unsorted positions, without building the hash */
+    static void scan_all(std::span<const int> _xs, std::span<const int> _ys, int _tileSize, const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits);
+
+private:
+    int calc_cell_column(int _x) const;
+    int calc_cell_row(int _y) const;
+
+    int tileSize;
+    SDL_Point gridOffset;
+    int cellSize;
+    int numCellRows;
+    int numCellCols;
+    std::vector<std::uint32_t> cellStarts;
+    std::vector<std::uint32_t> cellFill;
+    std::vector<std::uint32_t> entityCells;
+    std::vector<int> xs;
+    std::vector<int> ys;
+    std::vector<std::uint32_t> ids;
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef TEXTRENDERER_HPP
+#define TEXTRENDERER_HPP
+
+#include <array>
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Draws text from a glyph atlas rasterized once at startup. Each Label keeps
+ * the quads for its current string, so an unchanged label costs one
+ * SDL_RenderGeometry call and nothing is rasterized per frame. Without a
+ * font the atlas is built from the embedded bitmap glyphs instead. */
+class TextRenderer {
+public:
+    enum class Align {
+        left,
+        right,
+    };
+
+    struct Label {
+        std::string text;
+        SDL_Point position;
+        Align align;
+        SDL_Color color;
+        SDL_Rect rect;
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+    };
+
+    TextRenderer(
+        SDL_Renderer* _renderer,
+        TTF_Font* _font
+    );
+
+    Label make_label(SDL_Point _position, Align _align, SDL_Color _color) const;
+    void set_text(Label& _label, std::string_view _text) const;
+    void draw(const Label& _label) const;
+    int get_line_height() const;
+    void shutdown();
+
+private:
+    struct Glyph {
+        SDL_Rect rect;
+        int advance;
+    };
+
+    static constexpr char firstGlyph = ' ';
+    static constexpr char lastGlyph = '~';
+    static constexpr int embeddedScale = 2;
+
+    int init_line_height() const;
+    SDL_Surface* render_glyph(char _ch, int& _advance) const;
+    SDL_Surface* render_embedded_glyph(char _ch, int& _advance) const;
+    SDL_Texture* init_atlas();
+    void build_quads(Label& _label) const;
+
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    int lineHeight;
+    SDL_Point atlasSize;
+    std::array<Glyph, lastGlyph - firstGlyph + 1> glyphs;
+    SDL_Texture* atlas;
+};
+
+#endif
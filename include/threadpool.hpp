@@ -0,0 +1,60 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Worker threads that split a range of items with the calling thread.
+ * run() cuts the range into chunks and deals every thread an even,
+ * contiguous share of them. Each thread works through its own share from
+ * the front and, once that is empty, steals chunks from the back of the
+ * others', so a thread that falls behind does not hold up the rest. Chunks
+ * always cover the same items whichever thread runs them, so results kept
+ * per chunk and joined in chunk order come out the same on any number of
+ * threads. */
+class ThreadPool {
+public:
+    using Task = std::function<void(size_t _first, size_t _last)>;
+
+    /* Counts the calling thread, so one thread runs everything in place */
+    ThreadPool(unsigned int _numThreads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /* Calls _task on each run of up to _chunkSize items of [0, _count), on
+     * any of the threads, and returns once all of them are done */
+    void run(size_t _count, size_t _chunkSize, const Task& _task);
+
+private:
+    /* A thread's chunks still to run, first in the low half and last in the
+     * high half, so taking from either end is one compare-and-swap */
+    struct alignas(64) Share {
+        std::atomic<std::uint64_t> chunks;
+    };
+
+    void work_loop(unsigned int _thread);
+    void work(unsigned int _thread);
+    bool take(unsigned int _thread, size_t& _chunk);
+
+    unsigned int numThreads;
+    std::unique_ptr<Share[]> shares;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const Task* task;
+    size_t count;
+    size_t chunkSize;
+    std::uint64_t generation;
+    unsigned int numBusy;
+    bool stopping;
+};
+
+#endif
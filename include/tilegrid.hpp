@@ -0,0 +1,62 @@
+#ifndef TILEGRID_HPP
+#define TILEGRID_HPP
+
+#include <SDL.h>
+#include "tile.hpp"
+#include <vector>
+
+/* Tiles stored row-major in one block, one byte each, indexed by
+ * y * cols + x. It sizes itself at runtime and can copy a level's tiles into
+ * its storage without reallocating. */
+class TileGrid {
+public:
+    TileGrid(int _rows, int _cols) :
+        rows(_rows),
+        cols(_cols),
+        tiles(static_cast<size_t>(_rows * _cols), Tile::empty)
+    {}
+
+    TileGrid(int _rows, int _cols, const Tile* _tiles) :
+        rows(_rows),
+        cols(_cols),
+        tiles(_tiles, _tiles + _rows * _cols)
+    {}
+
+    /* Only reallocates if the dimensions grow */
+    void assign(int _rows, int _cols, const Tile* _tiles) {
+        rows = _rows;
+        cols = _cols;
+        tiles.assign(_tiles, _tiles + _rows * _cols);
+    }
+
+    int get_rows() const {
+        return rows;
+    }
+
+    int get_cols() const {
+        return cols;
+    }
+
+    bool contains(SDL_Point _position) const {
+        return _position.x >= 0 && _position.x < cols && _position.y >= 0 && _position.y < rows;
+    }
+
+    Tile& operator[](SDL_Point _position) {
+        return tiles[_position.y * cols + _position.x];
+    }
+
+    const Tile& operator[](SDL_Point _position) const {
+        return tiles[_position.y * cols + _position.x];
+    }
+
+    const Tile* data() const {
+        return tiles.data();
+    }
+
+private:
+    int rows;
+    int cols;
+    std::vector<Tile> tiles;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/* Lock-free single-producer, single-consumer triple buffer. The writer fills
+ * its back buffer and publishes it by swapping with the middle slot; the
+ * reader swaps its front buffer with the middle slot only when a newer one
+ * was published. Neither side ever waits on the other. */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() :
+        buffers(),
+        middle(1),
+        writeIndex(0),
+        readIndex(2)
+    {}
+
+    T& write_buffer() {
+        return buffers[writeIndex];
+    }
+
+    void publish() {
+        writeIndex = middle.exchange(writeIndex | dirtyBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & dirtyBit) == 0) {
+            return false;
+        }
+
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T& read_buffer() const {
+        return buffers[readIndex];
+    }
+
+private:
+    static constexpr std::uint8_t indexMask = 0x3;
+    static constexpr std::uint8_t dirtyBit = 0x4;
+
+    std::array<T, 3> buffers;
+    std::atomic<std::uint8_t> middle;
+    std::uint8_t writeIndex;
+    std::uint8_t readIndex;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "assets.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+Assets::Assets(const std::vector<std::string>& _preloadPaths) :
+    files(),
+    fonts()
+{
+    for (const auto& _path : _preloadPaths) {
+        preload(_path);
+    }
+}
+
+std::string Assets::find_font(const std::vector<std::string>& _candidates) {
+    for (const auto& _path : _candidates) {
+        std::error_code _error;
+        if (std::filesystem::is_regular_file(_path, _error)) {
+            return _path;
+        }
+    }
+
+    return "";
+}
+
+void Assets::preload(const std::string& _path) {
+    if (_path.empty() || files.count(_path) != 0) {
+        return;
+    }
+
+    files.emplace(_path, std::async(std::launch::async, read_file, _path).share());
+}
+
+std::vector<char> Assets::read_file(const std::string& _path) {
+    std::ifstream _file(_path, std::ios::binary | std::ios::ate);
+    if (!_file) {
+        return {};
+    }
+
+    std::vector<char> _bytes(static_cast<size_t>(_file.tellg()));
+    _file.seekg(0);
+    _file.read(_bytes.data(), static_cast<std::streamsize>(_bytes.size()));
+    return _bytes;
+}
+
+const std::vector<char>& Assets::get_file(const std::string& _path) {
+    preload(_path);
+    return files.at(_path).get();
+}
+
+/* Returns nullptr if the font cannot be loaded, so callers can fall back to the embedded font */
+TTF_Font* Assets::get_font(const std::string& _path, int _ptSize) {
+    if (_path.empty()) {
+        return nullptr;
+    }
+
+    const auto _key = std::make_pair(_path, _ptSize);
+    if (auto it = fonts.find(_key); it != fonts.end()) {
+        return it->second;
+    }
+
+    if (TTF_WasInit() == 0 && TTF_Init() == -1) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_Init() failed: %s", TTF_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    /* Every size of a face shares the one copy of the file in memory */
+    const std::vector<char>& _bytes = get_file(_path);
+    TTF_Font* _font = nullptr;
+    if (!_bytes.empty()) {
+        _font = TTF_OpenFontRW(SDL_RWFromConstMem(_bytes.data(), static_cast<int>(_bytes.size())), 1, _ptSize);
+    }
+    if (_font == nullptr) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_ERROR, "Could not load font %s: %s", _path.c_str(), TTF_GetError());
+    }
+
+    fonts.emplace(_key, _font);
+    return _font;
+}
+
+void Assets::shutdown() {
+    for (auto& [_key, _font] : fonts) {
+        if (_font != nullptr) {
+            TTF_CloseFont(_font);
+        }
+    }
+    fonts.clear();
+
+    files.clear();
+}
@@ -0,0 +1,171 @@
+#include "bitboard.hpp"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+Bitboard::Bitboard(int _rows, int _cols) :
+    rows(_rows),
+    cols(_cols),
+    words(static_cast<size_t>((_rows * _cols + 63) / 64), 0),
+    notFirstColumn(words.size(), ~std::uint64_t{0}),
+    notLastColumn(words.size(), ~std::uint64_t{0}),
+    scratch(words.size(), 0)
+{
+    for (int y = 0; y < rows; ++y) {
+        const int _first = y * cols;
+        const int _last = _first + cols - 1;
+        notFirstColumn[_first / 64] &= ~(std::uint64_t{1} << (_first % 64));
+        notLastColumn[_last / 64] &= ~(std::uint64_t{1} << (_last % 64));
+    }
+}
+
+int Bitboard::get_rows() const {
+    return rows;
+}
+
+int Bitboard::get_cols() const {
+    return cols;
+}
+
+void Bitboard::clear() {
+    std::fill(words.begin(), words.end(), 0);
+}
+
+void Bitboard::invert() {
+    for (auto& _word : words) {
+        _word = ~_word;
+    }
+    mask_tail();
+}
+
+bool Bitboard::any() const {
+    for (const auto _word : words) {
+        if (_word != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int Bitboard::count() const {
+    int _count = 0;
+    for (const auto _word : words) {
+        _count += std::popcount(_word);
+    }
+
+    return _count;
+}
+
+bool Bitboard::intersects(const Bitboard& _other) const {
+    for (size_t i = 0; i < words.size(); ++i) {
+        if ((words[i] & _other.words[i]) != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Bitboard& Bitboard::operator&=(const Bitboard& _other) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        words[i] &= _other.words[i];
+    }
+
+    return *this;
+}
+
+Bitboard& Bitboard::operator|=(const Bitboard& _other) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        words[i] |= _other.words[i];
+    }
+
+    return *this;
+}
+
+void Bitboard::shift(Direction _direction) {
+    switch (_direction) {
+        case Direction::up:
+            shift_right(cols);
+            break;
+        case Direction::down:
+            shift_left(cols);
+            break;
+        case Direction::left:
+            /* Drop bits that wrapped from the first column onto the previous row */
+            shift_right(1);
+            for (size_t i = 0; i < words.size(); ++i) {
+                words[i] &= notLastColumn[i];
+            }
+            break;
+        case Direction::right:
+            /* Drop bits that wrapped from the last column onto the next row */
+            shift_left(1);
+            for (size_t i = 0; i < words.size(); ++i) {
+                words[i] &= notFirstColumn[i];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Bitboard::dilate() {
+    /* Spread along rows, then spread that along columns */
+    for (const auto& [_first, _second] : {std::pair{Direction::left, Direction::right}, std::pair{Direction::up, Direction::down}}) {
+        scratch = words;
+        shift(_first);
+        std::swap(words, scratch);
+        for (size_t i = 0; i < words.size(); ++i) {
+            scratch[i] |= words[i];
+        }
+        shift(_second);
+        for (size_t i = 0; i < words.size(); ++i) {
+            words[i] |= scratch[i];
+        }
+    }
+}
+
+/* Toward higher tile indices */
+void Bitboard::shift_left(int _bits) {
+    const int _wordShift = _bits / 64;
+    const int _bitShift = _bits % 64;
+    const int _size = static_cast<int>(words.size());
+    for (int i = _size - 1; i >= 0; --i) {
+        const int _source = i - _wordShift;
+        std::uint64_t _word = 0;
+        if (_source >= 0) {
+            _word = words[_source] << _bitShift;
+            if (_bitShift != 0 && _source > 0) {
+                _word |= words[_source - 1] >> (64 - _bitShift);
+            }
+        }
+        words[i] = _word;
+    }
+    mask_tail();
+}
+
+/* Toward lower tile indices */
+void Bitboard::shift_right(int _bits) {
+    const int _wordShift = _bits / 64;
+    const int _bitShift = _bits % 64;
+    const int _size = static_cast<int>(words.size());
+    for (int i = 0; i < _size; ++i) {
+        const int _source = i + _wordShift;
+        std::uint64_t _word = 0;
+        if (_source < _size) {
+            _word = words[_source] >> _bitShift;
+            if (_bitShift != 0 && _source + 1 < _size) {
+                _word |= words[_source + 1] << (64 - _bitShift);
+            }
+        }
+        words[i] = _word;
+    }
+}
+
+void Bitboard::mask_tail() {
+    const int _tail = (rows * cols) % 64;
+    if (_tail != 0) {
+        words.back() &= (std::uint64_t{1} << _tail) - 1;
+    }
+}
@@ -0,0 +1,120 @@
+#include "bombsystem.hpp"
+#include "profiler.hpp"
+#include <utility>
+
+BombSystem::BombSystem(
+    int _numRows,
+    int _numCols,
+    int _tileSize,
+    SDL_Point _gridOffset
+) :
+    tileSize(_tileSize),
+    keys(),
+    motion(_numRows, _numCols, _tileSize, _gridOffset),
+    exploding(),
+    lifetimes()
+{}
+
+size_t BombSystem::size() const {
+    return motion.size();
+}
+
+bool BombSystem::empty() const {
+    return motion.size() == 0;
+}
+
+void BombSystem::reserve(size_t _capacity) {
+    keys.reserve(_capacity);
+    motion.reserve(_capacity);
+    exploding.reserve(_capacity);
+    lifetimes.reserve(_capacity);
+}
+
+void BombSystem::clear() {
+    keys.clear();
+    motion.clear();
+    exploding.clear();
+    lifetimes.clear();
+}
+
+Handle BombSystem::add(SDL_Point _position, double _speed, Direction _direction) {
+    motion.add(_position, tileSize - 0.01, _speed, _direction);
+    exploding.push_back(0);
+    lifetimes.push_back(0.2);
+
+    return keys.push();
+}
+
+void BombSystem::remove(size_t _index) {
+    const size_t _last = motion.size() - 1;
+    if (_index != _last) {
+        motion.swap(_index, _last);
+        std::swap(exploding[_index], exploding[_last]);
+        std::swap(lifetimes[_index], lifetimes[_last]);
+        keys.swap(_index, _last);
+    }
+    motion.pop_back();
+    exploding.pop_back();
+    lifetimes.pop_back();
+    keys.pop();
+}
+
+Handle BombSystem::get_handle(size_t _index) const {
+    return keys.get_handle(_index);
+}
+
+bool BombSystem::contains(Handle _handle) const {
+    return keys.contains(_handle);
+}
+
+size_t BombSystem::find(Handle _handle) const {
+    return keys.find(_handle);
+}
+
+/* The bomb's tile and its eight neighbours */
+SDL_Rect BombSystem::get_blast_rect(size_t _index) const {
+    const SDL_Rect _rect = motion.get_rect(_index);
+    return {_rect.x - tileSize, _rect.y - tileSize, 3 * tileSize, 3 * tileSize};
+}
+
+/* The bomb's rect lies within its tile and the next, and the blast grows it
+ * by a tile on every side */
+void BombSystem::get_blast_area(size_t _index, Bitboard& _area) const {
+    _area.clear();
+    _area.set(motion.get_position(_index));
+    _area.set(motion.get_next_position(_index));
+    _area.dilate();
+}
+
+/* The board's edge counts as a wall: on an open edge the next position is
+ * clamped to the bomb's own tile, so it would otherwise wait there forever,
+ * holding one of the limited bomb slots */
+bool BombSystem::hits_wall(size_t _index, const Bitboard& _walls) const {
+    return (motion.get_events(_index) & MotionTable::reachedEdge) != 0 || _walls.test(motion.get_next_position(_index));
+}
+
+/* A lit bomb stops where it is, and the movement system carries it along at no speed */
+SDL_Rect BombSystem::explode(size_t _index, double _dt) {
+    SDL_Rect _explosion = get_blast_rect(_index);
+    if (exploding[_index] == 0) {
+        exploding[_index] = 1;
+        motion.set_speed(_index, 0.0);
+        _explosion.h = 0;
+        return _explosion;
+    }
+    lifetimes[_index] -= _dt;
+    if (lifetimes[_index] > 0) {
+        return _explosion;
+    }
+    _explosion.h = 0;
+    return _explosion;
+}
+
+void BombSystem::move(double _dt) {
+    PROFILE_ZONE("BombSystem::move");
+    motion.integrate(0, motion.size(), _dt, Arrival::carry);
+}
+
+void BombSystem::translate(SDL_Point _delta) {
+    motion.translate(_delta);
+}
@@ -0,0 +1,52 @@
+#include "chunkcache.hpp"
+#include "profiler.hpp"
+
+ChunkCache::ChunkCache(const Level& _level, int _capacity) :
+    level(_level),
+    chunkArea(static_cast<size_t>(level.get_chunk_size()) * level.get_chunk_size()),
+    tiles(chunkArea * _capacity),
+    slotChunks(static_cast<size_t>(_capacity), SDL_Point({-1, -1})),
+    slotUses(static_cast<size_t>(_capacity), 0),
+    useClock(0),
+    misses(0)
+{}
+
+int ChunkCache::find(SDL_Point _chunk) const {
+    for (size_t i = 0; i < slotChunks.size(); ++i) {
+        if (slotChunks[i].x == _chunk.x && slotChunks[i].y == _chunk.y) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+const Tile* ChunkCache::get(SDL_Point _chunk) {
+    int _slot = find(_chunk);
+    if (_slot < 0) {
+        PROFILE_ZONE("ChunkCache::get miss");
+        _slot = 0;
+        for (size_t i = 1; i < slotUses.size(); ++i) {
+            if (slotUses[i] < slotUses[_slot]) {
+                _slot = static_cast<int>(i);
+            }
+        }
+        level.read_chunk(_chunk, &tiles[_slot * chunkArea]);
+        slotChunks[_slot] = _chunk;
+        ++misses;
+    }
+
+    slotUses[_slot] = ++useClock;
+    return &tiles[_slot * chunkArea];
+}
+
+/* Chunks already in the cache need no read-ahead */
+void ChunkCache::prefetch(SDL_Point _chunk) const {
+    if (find(_chunk) < 0) {
+        level.prefetch_chunk(_chunk);
+    }
+}
+
+unsigned long ChunkCache::get_misses() const {
+    return misses;
+}
@@ -0,0 +1,242 @@
+#include "enemysystem.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+/* The open directions for each legal-move mask, in up, down, left, right
+ * order, so a wandering enemy turns with a single draw and no loop */
+struct Turns {
+    unsigned int count;
+    Direction directions[4];
+};
+
+static constexpr std::array<Turns, 32> turnTable = [] {
+    std::array<Turns, 32> _table{};
+    for (unsigned int _moves = 0; _moves < _table.size(); ++_moves) {
+        for (const Direction _candidate : {Direction::up, Direction::down, Direction::left, Direction::right}) {
+            if (_moves & 1u << static_cast<int>(_candidate)) {
+                _table[_moves].directions[_table[_moves].count++] = _candidate;
+            }
+        }
+    }
+    return _table;
+}();
+
+/* Below this many active enemies a tick's work is too short to be worth
+ * waking the pool for */
+static constexpr size_t parallelThreshold = 8192;
+static constexpr size_t chunkSize = 1024;
+
+EnemySystem::EnemySystem(
+    int _numRows,
+    int _numCols,
+    int _tileSize,
+    SDL_Point _gridOffset,
+    ThreadPool& _threadPool
+) :
+    tileSize(_tileSize),
+    numActive(0),
+    keys(),
+    motion(_numRows, _numCols, _tileSize, _gridOffset),
+    randoms(),
+    cells(_numRows, _numCols, _tileSize, _gridOffset),
+    queriesSinceChange(0),
+    occupancy(_numRows, _numCols),
+    occupancyValid(false),
+    threadPool(_threadPool),
+    chunkHits()
+{}
+
+size_t EnemySystem::size() const {
+    return numActive;
+}
+
+bool EnemySystem::empty() const {
+    return numActive == 0;
+}
+
+size_t EnemySystem::get_num_dormant() const {
+    return motion.size() - numActive;
+}
+
+void EnemySystem::clear() {
+    while (motion.size() != 0) {
+        pop_back();
+    }
+    numActive = 0;
+    occupancyValid = false;
+}
+
+Handle EnemySystem::add(SDL_Point _position, double _speed, Direction _direction, Random _random, bool _active) {
+    motion.add(_position, tileSize - 0.01, _speed, _direction);
+    randoms.push_back(_random);
+    const Handle _handle = keys.push();
+    if (_active) {
+        swap_elements(numActive++, motion.size() - 1);
+    }
+    queriesSinceChange = 0;
+    occupancyValid = false;
+
+    return _handle;
+}
+
+Handle EnemySystem::get_handle(size_t _index) const {
+    return keys.get_handle(_index);
+}
+
+bool EnemySystem::contains(Handle _handle) const {
+    return keys.contains(_handle);
+}
+
+/* Active enemies have indices below size() */
+size_t EnemySystem::find(Handle _handle) const {
+    return keys.find(_handle);
+}
+
+void EnemySystem::move(const Grid& _grid, const FlowField* _flowField, double _dt) {
+    PROFILE_ZONE("EnemySystem::move");
+    queriesSinceChange = 0;
+    occupancyValid = false;
+    if (numActive < parallelThreshold) {
+        move_range(0, numActive, _grid, _flowField, _dt);
+        return;
+    }
+    threadPool.run(numActive, chunkSize, [&](size_t _first, size_t _last) {
+        move_range(_first, _last, _grid, _flowField, _dt);
+    });
+}
+
+void EnemySystem::move_range(size_t _first, size_t _last, const Grid& _grid, const FlowField* _flowField, double _dt) {
+    motion.integrate(_first, _last, _dt, Arrival::stop);
+
+    /* Only enemies that reached a new tile or stopped at an open edge choose
+     * where to go next */
+    for (size_t i = _first; i < _last; ++i) {
+        if (motion.get_events(i) & (MotionTable::reachedTile | MotionTable::reachedEdge)) {
+            set_direction(i, _grid, _flowField);
+        }
+    }
+}
+
+/* Chasers follow the flow field while the target is reachable; otherwise
+ * pick uniformly among the open neighbours */
+void EnemySystem::set_direction(size_t _index, const Grid& _grid, const FlowField* _flowField) {
+    const SDL_Point _position = get_position(_index);
+    if (_flowField != nullptr) {
+        if (const Direction _chase = _flowField->get_direction(_position); _chase != Direction::none) {
+            motion.set_direction(_index, _chase);
+            return;
+        }
+    }
+
+    const Turns& _turns = turnTable[_grid.get_legal_moves(_position)];
+
+    /* Boxed in: stay put facing the same way */
+    if (_turns.count == 0) {
+        return;
+    }
+
+    motion.set_direction(_index, _turns.directions[randoms[_index].below(_turns.count)]);
+}
+
+void EnemySystem::find_hits(const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits) {
+    PROFILE_ZONE("EnemySystem::find_hits");
+    /* A single query, like the player's each tick, is cheaper as a straight
+     * scan; the hash is built once a second query comes before the enemies
+     * change again, and then serves every blast that tick */
+    ++queriesSinceChange;
+    if (queriesSinceChange == 1) {
+        if (numActive < parallelThreshold) {
+            SpatialHash::scan_all({motion.get_rect_xs().data(), numActive}, {motion.get_rect_ys().data(), numActive}, tileSize, _rect, _hits);
+        } else {
+            scan_chunks(_rect, _hits);
+        }
+        return;
+    }
+    if (queriesSinceChange == 2) {
+        cells.build({motion.get_rect_xs().data(), numActive}, {motion.get_rect_ys().data(), numActive});
+    }
+    cells.query(_rect, _hits);
+}
+
+/* Each chunk scans into its own list; joined in chunk order they are the
+ * ascending indices one scan of every enemy would give */
+void EnemySystem::scan_chunks(const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits) {
+    chunkHits.resize((numActive + chunkSize - 1) / chunkSize);
+    threadPool.run(numActive, chunkSize, [&](size_t _first, size_t _last) {
+        SpatialHash::scan_all({motion.get_rect_xs().data() + _first, _last - _first}, {motion.get_rect_ys().data() + _first, _last - _first}, tileSize, _rect, chunkHits[_first / chunkSize]);
+    });
+
+    _hits.clear();
+    for (size_t c = 0; c < chunkHits.size(); ++c) {
+        const std::uint32_t _base = static_cast<std::uint32_t>(c * chunkSize);
+        for (const std::uint32_t _index : chunkHits[c]) {
+            _hits.push_back(_base + _index);
+        }
+    }
+}
+
+/* An enemy's rect lies within its tile and the next, so these two bits cover it */
+const Bitboard& EnemySystem::get_occupancy() {
+    if (!occupancyValid) {
+        occupancy.clear();
+        for (size_t i = 0; i < numActive; ++i) {
+            occupancy.set(get_position(i));
+            occupancy.set(get_next_position(i));
+        }
+        occupancyValid = true;
+    }
+
+    return occupancy;
+}
+
+/* From the back, so the enemies swapped into the gaps have been kept */
+void EnemySystem::remove(const std::vector<std::uint32_t>& _indices) {
+    for (auto _index = _indices.rbegin(); _index != _indices.rend(); ++_index) {
+        /* The last active enemy fills the gap, and the last dormant one fills its place */
+        swap_elements(*_index, --numActive);
+        swap_elements(numActive, motion.size() - 1);
+        pop_back();
+    }
+}
+
+void EnemySystem::translate(SDL_Point _delta) {
+    queriesSinceChange = 0;
+    occupancyValid = false;
+    motion.translate(_delta);
+}
+
+void EnemySystem::update_activity(const Grid& _grid) {
+    occupancyValid = false;
+    for (size_t i = 0; i < numActive;) {
+        if (_grid.contains(get_position(i))) {
+            ++i;
+        } else {
+            swap_elements(i, --numActive);
+        }
+    }
+    for (size_t i = numActive; i < motion.size(); ++i) {
+        if (_grid.contains(get_position(i))) {
+            swap_elements(i, numActive++);
+        }
+    }
+}
+
+void EnemySystem::swap_elements(size_t _first, size_t _second) {
+    if (_first == _second) {
+        return;
+    }
+
+    motion.swap(_first, _second);
+    std::swap(randoms[_first], randoms[_second]);
+    keys.swap(_first, _second);
+    queriesSinceChange = 0;
+}
+
+void EnemySystem::pop_back() {
+    motion.pop_back();
+    randoms.pop_back();
+    keys.pop();
+    queriesSinceChange = 0;
+}
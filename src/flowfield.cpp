@@ -0,0 +1,69 @@
+#include "flowfield.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <utility>
+
+FlowField::FlowField(int _rows, int _cols) :
+    rows(_rows),
+    cols(_cols),
+    directions(static_cast<size_t>(_rows * _cols), Direction::none),
+    distances(static_cast<size_t>(_rows * _cols), -1),
+    frontier(static_cast<size_t>(_rows * _cols)),
+    target({-1, -1}),
+    layoutVersion(0)
+{}
+
+void FlowField::update(const Grid& _grid, SDL_Point _target) {
+    if (_target.x == target.x && _target.y == target.y && _grid.get_layout_version() == layoutVersion) {
+        return;
+    }
+
+    PROFILE_ZONE("FlowField::update");
+    target = _target;
+    layoutVersion = _grid.get_layout_version();
+    std::fill(directions.begin(), directions.end(), Direction::none);
+    std::fill(distances.begin(), distances.end(), -1);
+
+    /* Walk outward from the target; each tile reached points back the way it was reached from */
+    size_t _head = 0;
+    size_t _tail = 0;
+    frontier[_tail++] = target.y * cols + target.x;
+    distances[frontier[0]] = 0;
+    while (_head < _tail) {
+        const int _index = frontier[_head++];
+        const SDL_Point _position = {_index % cols, _index / cols};
+        const unsigned int _moves = _grid.get_legal_moves(_position);
+        for (const auto& [_step, _back] : {
+            std::pair{Direction::up, Direction::down},
+            std::pair{Direction::down, Direction::up},
+            std::pair{Direction::left, Direction::right},
+            std::pair{Direction::right, Direction::left}
+        }) {
+            if ((_moves & 1u << static_cast<int>(_step)) == 0) {
+                continue;
+            }
+
+            int _next = _index;
+            switch (_step) {
+                case Direction::up:
+                    _next -= cols;
+                    break;
+                case Direction::down:
+                    _next += cols;
+                    break;
+                case Direction::left:
+                    _next -= 1;
+                    break;
+                default:
+                    _next += 1;
+                    break;
+            }
+
+            if (distances[_next] < 0) {
+                distances[_next] = distances[_index] + 1;
+                directions[_next] = _back;
+                frontier[_tail++] = _next;
+            }
+        }
+    }
+}
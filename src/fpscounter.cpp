@@ -1,61 +1,45 @@
 #include "fpscounter.hpp"
 #include <cmath>
+#include <cstdio>
 #include <string>
+#include <string_view>
 #include <cstdlib>
+#include <fstream>
 
 FPSCounter::FPSCounter(
     SDL_Window* _window,
-    SDL_Renderer* _renderer
+    SDL_Renderer* _renderer,
+    const TextRenderer* _textRenderer
 ) :
     window(_window),
     renderer(_renderer),
-    textColor({255, 255, 255, SDL_ALPHA_OPAQUE}),
-    font(init_font("/System/Library/Fonts/Monaco.ttf", 14)),
-    textureRect(set_textureRect("0")),
+    textRenderer(_textRenderer),
+    windowWidth(init_window_width()),
+    label(textRenderer->make_label({windowWidth, 0}, TextRenderer::Align::right, {255, 255, 255, SDL_ALPHA_OPAQUE})),
     prevTime(),
     prevTimeValid(false),
     updateRate(10.0),
-    frameCount(0)
-{}
-
-TTF_Font* FPSCounter::init_font(const char* _fontPath, int _fontPtSize) {
-    if (TTF_Init() == -1) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_Init() failed: %s", TTF_GetError());
-        exit(EXIT_FAILURE);
-    }
-    
-    TTF_Font* _font = TTF_OpenFont(_fontPath, _fontPtSize);
-    if (_font == nullptr) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_OpenFont() failed: %s", TTF_GetError());
-        exit(EXIT_FAILURE);
+    frameCount(0),
+    prevFrameTime(),
+    frameHistogram(),
+    phaseHistograms(),
+    overlayOn(false),
+    overlayLabels()
+{
+    textRenderer->set_text(label, "0");
+    for (int i = 0; i < phaseCount + 2; ++i) {
+        overlayLabels.push_back(textRenderer->make_label({windowWidth, textRenderer->get_line_height() * (i + 1)}, TextRenderer::Align::right, {255, 255, 255, SDL_ALPHA_OPAQUE}));
     }
-    
-    return _font;
 }
 
-FPSCounter::TextureRect FPSCounter::set_textureRect(const char* _fpsText) {
-    SDL_Surface* _surface = TTF_RenderUTF8_Solid(font, _fpsText, textColor);
-    if (_surface == nullptr) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_RenderUTF8_Solid() failed: %s", TTF_GetError());
-        exit(EXIT_FAILURE);
-    }
-    
-    SDL_Texture* _texture = SDL_CreateTextureFromSurface(renderer, _surface);
-    if (_texture == nullptr) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_CreateTextureFromSurface() failed: %s", SDL_GetError());
-        exit(EXIT_FAILURE);
-    }
-    
+int FPSCounter::init_window_width() const {
     int _windowWidth;
     if (SDL_GetRendererOutputSize(renderer, &_windowWidth, nullptr) < 0) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_GetRendererOutputSize() failed: %s", SDL_GetError());
         exit(EXIT_FAILURE);
     }
-    
-    SDL_Rect _rect = SDL_Rect{_windowWidth - _surface->w, 0, _surface->w, _surface->h};
-    SDL_FreeSurface(_surface);
-    
-    return TextureRect{_texture, _rect};
+
+    return _windowWidth;
 }
 
 void FPSCounter::draw() {
@@ -64,13 +48,19 @@ void FPSCounter::draw() {
     if (!prevTimeValid) {
         frameCount = 0;
         prevTime = _currTime;
+        prevFrameTime = _currTime;
         prevTimeValid = true;
         return;
     }
+
+    frameHistogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(_currTime - prevFrameTime).count());
+    prevFrameTime = _currTime;
     
-    if (SDL_RenderCopy(renderer, textureRect.texture, nullptr, &textureRect.rect) < 0) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_RenderCopy() failed: %s", SDL_GetError());
-        exit(EXIT_FAILURE);
+    textRenderer->draw(label);
+    if (overlayOn) {
+        for (const auto& _overlayLabel : overlayLabels) {
+            textRenderer->draw(_overlayLabel);
+        }
     }
     
     auto _interval = std::chrono::duration_cast<std::chrono::nanoseconds>(_currTime - prevTime).count();
@@ -79,22 +69,80 @@ void FPSCounter::draw() {
     }
     
     long _fps = std::lround(1e9 / _interval * frameCount);
-    std::string _fpsString = std::to_string(_fps);
-    const char* _fpsText = _fpsString.c_str();
-    
-    SDL_DestroyTexture(textureRect.texture);
-    textureRect = set_textureRect(_fpsText);
+    textRenderer->set_text(label, std::to_string(_fps));
+    if (overlayOn) {
+        update_overlay();
+    }
     
     frameCount = 0;
     prevTime = _currTime;
 }
 
-void FPSCounter::shutdown() {
-    if (font != nullptr) {
-        TTF_CloseFont(font);
+void FPSCounter::record_phase(Phase _phase, std::chrono::nanoseconds _duration) {
+    phaseHistograms[static_cast<int>(_phase)].record(_duration.count());
+}
+
+void FPSCounter::toggle_overlay() {
+    overlayOn = !overlayOn;
+    if (overlayOn) {
+        update_overlay();
     }
-    
-    if (textureRect.texture != nullptr) {
-        SDL_DestroyTexture(textureRect.texture);
+}
+
+void FPSCounter::update_overlay() {
+    textRenderer->set_text(overlayLabels[0], "ms p50/p95/p99/p99.9/max");
+    textRenderer->set_text(overlayLabels[1], format_series("frame", frameHistogram));
+    for (int i = 0; i < phaseCount; ++i) {
+        textRenderer->set_text(overlayLabels[i + 2], format_series(phaseNames[i], phaseHistograms[i]));
+    }
+}
+
+std::string FPSCounter::format_series(const char* _name, const Histogram& _histogram) {
+    char _buf[96];
+    std::snprintf(_buf, sizeof(_buf), "%-7s %.2f/%.2f/%.2f/%.2f/%.2f",
+        _name,
+        _histogram.get_percentile(50.0) / 1e6,
+        _histogram.get_percentile(95.0) / 1e6,
+        _histogram.get_percentile(99.0) / 1e6,
+        _histogram.get_percentile(99.9) / 1e6,
+        _histogram.get_max() / 1e6
+    );
+
+    return _buf;
+}
+
+void FPSCounter::dump(const char* _path) const {
+    std::ofstream _file(_path);
+    if (!_file) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to write frame statistics: %s", _path);
+        return;
+    }
+
+    const bool _json = std::string_view(_path).ends_with(".json");
+    const char* _names[phaseCount + 1] = {"frame", phaseNames[0], phaseNames[1], phaseNames[2], phaseNames[3]};
+    const Histogram* _histograms[phaseCount + 1] = {&frameHistogram, &phaseHistograms[0], &phaseHistograms[1], &phaseHistograms[2], &phaseHistograms[3]};
+
+    char _buf[256];
+    _file << (_json ? "{\n" : "series,count,mean_ms,p50_ms,p95_ms,p99_ms,p99.9_ms,max_ms\n");
+    for (int i = 0; i < phaseCount + 1; ++i) {
+        const Histogram& _histogram = *_histograms[i];
+        std::snprintf(_buf, sizeof(_buf),
+            _json
+                ? "  \"%s\": {\"count\": %llu, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"p99.9_ms\": %.4f, \"max_ms\": %.4f}%s\n"
+                : "%s,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f%s\n",
+            _names[i],
+            static_cast<unsigned long long>(_histogram.get_count()),
+            _histogram.get_mean() / 1e6,
+            _histogram.get_percentile(50.0) / 1e6,
+            _histogram.get_percentile(95.0) / 1e6,
+            _histogram.get_percentile(99.0) / 1e6,
+            _histogram.get_percentile(99.9) / 1e6,
+            _histogram.get_max() / 1e6,
+            _json && i < phaseCount ? "," : ""
+        );
+        _file << _buf;
+    }
+    if (_json) {
+        _file << "}\n";
     }
 }
@@ -0,0 +1,144 @@
+#include "framepacer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer(
+    SDL_Renderer* _renderer,
+    Mode _mode,
+    double _targetRate
+) :
+    renderer(_renderer),
+    mode(_mode),
+    targetRate(_targetRate),
+    period(std::llround(1e9 / targetRate)),
+    vsyncOn(false),
+    deadline(),
+    prevTime(),
+    prevTimeValid(false),
+    spinThreshold(std::chrono::milliseconds(2)),
+    missedFrames(0),
+    metFrames(0),
+    meanError(0.0),
+    maxError(0.0)
+{
+    set_mode(mode);
+}
+
+void FramePacer::set_mode(Mode _mode) {
+    log_error();
+
+    mode = _mode;
+    set_vsync(mode == Mode::vsync || mode == Mode::adaptive);
+    prevTimeValid = false;
+    missedFrames = 0;
+    metFrames = 0;
+    meanError = 0.0;
+    maxError = 0.0;
+}
+
+void FramePacer::set_vsync(bool _vsyncOn) {
+    if (SDL_RenderSetVSync(renderer, _vsyncOn ? 1 : 0) < 0) {
+        /* Not fatal: pacing falls back to the timer */
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_RenderSetVSync() failed: %s", SDL_GetError());
+        vsyncOn = false;
+        return;
+    }
+
+    vsyncOn = _vsyncOn;
+}
+
+void FramePacer::wait() {
+    if (!prevTimeValid) {
+        prevTime = highest_resolution_steady_clock::now();
+        deadline = prevTime + period;
+        prevTimeValid = true;
+        return;
+    }
+
+    if (mode == Mode::capped || mode == Mode::adaptive) {
+        sleep_until(deadline);
+    }
+
+    const auto _currTime = highest_resolution_steady_clock::now();
+    const auto _interval = _currTime - prevTime;
+    track_error(_currTime);
+
+    /* Adaptive mode drops vsync rather than halving the frame rate when frames run long */
+    if (mode == Mode::adaptive) {
+        if (vsyncOn) {
+            missedFrames = _interval > period * 3 / 2 ? missedFrames + 1 : 0;
+            if (missedFrames >= 3) {
+                set_vsync(false);
+                missedFrames = 0;
+            }
+        } else {
+            metFrames = _interval < period * 21 / 20 ? metFrames + 1 : 0;
+            if (metFrames >= 120) {
+                set_vsync(true);
+                metFrames = 0;
+            }
+        }
+    }
+
+    /* Schedule from the previous deadline so rounding cannot drift, unless a whole frame was lost */
+    deadline += period;
+    if (deadline < _currTime) {
+        deadline = _currTime + period;
+    }
+}
+
+void FramePacer::sleep_until(std::chrono::time_point<highest_resolution_steady_clock> _deadline) {
+    const auto _sleepStart = highest_resolution_steady_clock::now();
+    const auto _sleepTime = _deadline - _sleepStart - spinThreshold;
+    if (_sleepTime > std::chrono::nanoseconds::zero()) {
+        std::this_thread::sleep_for(_sleepTime);
+
+        /* Learn how far the OS oversleeps so the spin covers it next time */
+        const auto _overshoot = std::chrono::duration_cast<std::chrono::nanoseconds>(highest_resolution_steady_clock::now() - _sleepStart - _sleepTime);
+        const auto _threshold = std::max(_overshoot, std::chrono::nanoseconds::zero()) + std::chrono::microseconds(250);
+        spinThreshold = std::clamp(
+            (spinThreshold * 7 + _threshold) / 8,
+            std::chrono::nanoseconds(std::chrono::microseconds(250)),
+            std::chrono::nanoseconds(std::chrono::milliseconds(4))
+        );
+    }
+
+    while (highest_resolution_steady_clock::now() < _deadline);
+}
+
+/* Uncapped frames have no target interval to miss */
+void FramePacer::track_error(std::chrono::time_point<highest_resolution_steady_clock> _currTime) {
+    if (mode == Mode::uncapped) {
+        prevTime = _currTime;
+        return;
+    }
+
+    const double _error = std::abs(std::chrono::duration<double, std::milli>(_currTime - prevTime - period).count());
+    meanError = meanError * 0.95 + _error * 0.05;
+    maxError = std::max(maxError, _error);
+    prevTime = _currTime;
+}
+
+void FramePacer::log_error() const {
+    if (!prevTimeValid || mode == Mode::uncapped) {
+        return;
+    }
+
+    SDL_Log("Frame pacing %s: mean error %.3f ms, max error %.3f ms", mode_name(mode), meanError, maxError);
+}
+
+const char* FramePacer::mode_name(Mode _mode) {
+    switch (_mode) {
+        case Mode::vsync:
+            return "vsync";
+        case Mode::capped:
+            return "capped";
+        case Mode::uncapped:
+            return "uncapped";
+        case Mode::adaptive:
+            return "adaptive";
+        default:
+            return "unknown";
+    }
+}
@@ -1,25 +1,37 @@
 #include "game.hpp"
+#include "interpolate.hpp"
+#include "profiler.hpp"
 #include <SDL.h>
 #include <vector>
 
 Game::Game(
     SDL_Window* _window,
-    SDL_Renderer* _renderer
+    SDL_Renderer* _renderer,
+    const TextRenderer* _textRenderer,
+    const Level& _level,
+    EnemyMode _enemyMode,
+    int _maxBombs,
+    ThreadPool& _threadPool,
+    std::uint64_t _seed
 ) :
     window(_window),
     renderer(_renderer),
     state(State::newGame),
     keyboard(),
-    numRows(16),
-    numCols(16),
+    level(_level),
     tileSize(48),
+    random(_seed),
     grid(
         window,
         renderer,
-        numRows,
-        numCols,
-        tileSize
+        level,
+        tileSize,
+        random.fork()
     ),
+    numRows(grid.get_rows()),
+    numCols(grid.get_cols()),
+    enemyMode(_enemyMode),
+    flowField(numRows, numCols),
     player(
         window,
         renderer,
@@ -27,104 +39,138 @@ Game::Game(
         numCols,
         tileSize,
         grid.get_grid_offset(),
-        SDL_Point({2, 8}),
-        5.0 * tileSize,
+        grid.to_board(level.get_player_spawn()),
+        level.get_player_speed() * tileSize,
         Direction::right
     ),
-    enemies(
-        {
-            Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({7, 7}),
-                3.0 * tileSize,
-                Direction::right
-            ),
-            Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({8, 7}),
-                3.0 * tileSize,
-                Direction::right
-            ),
-            Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({7, 8}),
-                3.0 * tileSize,
-                Direction::right
-            ),
-            Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({8, 8}),
-                3.0 * tileSize,
-                Direction::right
-            )
-        }
-    ),
+    bombs(numRows, numCols, tileSize, grid.get_grid_offset()),
+    enemies(numRows, numCols, tileSize, grid.get_grid_offset(), _threadPool),
+    enemyHits(),
+    blastArea(numRows, numCols),
     hud(
         window,
-        renderer
-    )
-{}
+        renderer,
+        _textRenderer,
+        level.get_name()
+    ),
+    camera(calc_view_size()),
+    gameOverTime(0.0),
+    gameOverDelay(2.0),
+    maxBombs(static_cast<size_t>(_maxBombs)),
+    bombInterval(0.15),
+    bombCooldown(0.0),
+    flashCount(0),
+    drawnFlashCount(0)
+{
+    /* Throwing and spent blasts recycle these slots, so bomb spam never allocates */
+    bombs.reserve(maxBombs);
+    spawn_enemies();
+}
+
+SDL_Point Game::calc_view_size() const {
+    /* Headless games have no view */
+    if (renderer == nullptr) {
+        return {0, 0};
+    }
+
+    SDL_Point _viewSize;
+    if (SDL_GetRendererOutputSize(renderer, &_viewSize.x, &_viewSize.y) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_GetRendererOutputSize() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    return _viewSize;
+}
+
+/* One enemy per spawn point in the level, each with its own random stream.
+ * Enemies off the board of a chunked level wait, dormant, until it reaches them. */
+void Game::spawn_enemies() {
+    enemies.clear();
+    for (int i = 0; i < level.get_num_enemy_spawns(); ++i) {
+        const SDL_Point _position = grid.to_board(level.get_enemy_spawn(i));
+        enemies.add(
+            _position,
+            level.get_enemy_speed() * tileSize,
+            Direction::right,
+            random.fork(),
+            grid.contains(_position)
+        );
+    }
+}
+
+/* Moves everything with the board when it follows the player into another
+ * chunk, waking the enemies it reaches and parking the ones it leaves */
+void Game::follow_player() {
+    const SDL_Point _shift = grid.follow(player.get_next_position(), player.get_direction());
+    if (_shift.x == 0 && _shift.y == 0) {
+        return;
+    }
+
+    const SDL_Point _delta = {-_shift.x, -_shift.y};
+    player.translate(_delta);
+    bombs.translate(_delta);
+    for (size_t i = 0; i < bombs.size();) {
+        if (grid.contains(bombs.get_position(i))) {
+            ++i;
+        } else {
+            bombs.remove(i);
+        }
+    }
+
+    enemies.translate(_delta);
+    enemies.update_activity(grid);
+}
 
 bool Game::gameOn() const {
     return state != State::quitGame;
 }
 
-void Game::poll() {
-    for (SDL_Event _event; SDL_PollEvent(&_event) != 0;) {
-        if (_event.type == SDL_QUIT || (_event.type == SDL_KEYDOWN && _event.key.keysym.sym == SDLK_ESCAPE)) {
-            state = State::quitGame;
-            return;
-        }
-        
-        if (_event.type == SDL_KEYDOWN || _event.type == SDL_KEYUP) {
-            if (_event.key.keysym.sym == SDLK_w || _event.key.keysym.sym == SDLK_a || _event.key.keysym.sym == SDLK_s || _event.key.keysym.sym == SDLK_d) {
-                keyboard.set_key(&_event);
-                player.set_direction(keyboard, _event.key.keysym.sym);
-            } else if (_event.key.keysym.sym == SDLK_SPACE) {
-                player.bombs.emplace_back(Bomb(
-                    window,
-                    renderer,
-                    numRows,
-                    numCols,
-                    tileSize,
-                    grid.get_grid_offset(),
-                    player.get_next_position(),
-                    7.0 * tileSize,
-                    player.direction
-                ));
+bool Game::roundOver() const {
+    return state == State::gameOver;
+}
+
+int Game::get_level() const {
+    return hud.get_level();
+}
+
+unsigned long Game::get_chunk_misses() const {
+    return grid.get_chunk_misses();
+}
+
+void Game::handle_event(const SDL_Event& _event) {
+    PROFILE_ZONE("Game::handle_event");
+    if (_event.type == SDL_QUIT || (_event.type == SDL_KEYDOWN && _event.key.keysym.sym == SDLK_ESCAPE)) {
+        state = State::quitGame;
+        return;
+    }
+
+    if (_event.type == SDL_KEYDOWN || _event.type == SDL_KEYUP) {
+        if (_event.key.keysym.sym == SDLK_w || _event.key.keysym.sym == SDLK_a || _event.key.keysym.sym == SDLK_s || _event.key.keysym.sym == SDLK_d) {
+            keyboard.set_key(&_event);
+            player.set_direction(keyboard, _event.key.keysym.sym);
+        } else if (_event.key.keysym.sym == SDLK_SPACE && _event.type == SDL_KEYDOWN && _event.key.repeat == 0) {
+            /* One bomb per press, at most one per bombInterval and maxBombs at once */
+            if (bombCooldown > 0.0 || bombs.size() >= maxBombs) {
+                return;
             }
+            bombCooldown = bombInterval;
+            bombs.add(player.get_next_position(), level.get_bomb_speed() * tileSize, player.get_direction());
         }
     }
 }
 
-void Game::step() {
+void Game::step(double _dt) {
+    PROFILE_ZONE("Game::step");
     std::vector<SDL_Keycode> _movementKeys{SDLK_w, SDLK_a, SDLK_s, SDLK_d};
     SDL_Point _pos, _prevPos, _currPos;
     int _turned, _status;
     SDL_Rect playerRect;
-    std::vector<int> bombIndexes;
-    SDL_Rect explosion, enemyRect;
+    SDL_Rect explosion;
     size_t i;
+    const FlowField* _flowField;
+    if (bombCooldown > 0.0) {
+        bombCooldown -= _dt;
+    }
     switch (state) {
         case State::newGame:
             for (const auto _key : _movementKeys) {
@@ -138,57 +184,47 @@ void Game::step() {
         case State::playGame:
             _pos = player.get_position();
             _prevPos = player.get_next_position();
-            _turned = player.move();
+            _turned = player.move(_dt);
             playerRect = player.get_rect();
-            for (auto& enemy : enemies) {
-                enemy.move(grid.grid);
-                enemy.check_collision(playerRect);
-                if (enemy.check_collision(playerRect)) {
-                    state = State::gameOver;
-                    return;
-                }
+
+            /* One search toward the player serves every chasing enemy */
+            _flowField = nullptr;
+            if (enemyMode == EnemyMode::chase && !enemies.empty()) {
+                flowField.update(grid, player.get_position());
+                _flowField = &flowField;
+            }
+
+            enemies.move(grid, _flowField, _dt);
+            enemies.find_hits(playerRect, enemyHits);
+            if (!enemyHits.empty()) {
+                state = State::gameOver;
+                return;
             }
             _currPos = player.get_next_position();
             _status = grid.update(_prevPos, _currPos);
-            for (auto& bomb : player.bombs) {
-                bombIndexes.push_back(0);
-                if (!bomb.exploding) {
-                    bomb.move();
-                }
-                if (bomb.check_collision(grid.grid)) {
-                    explosion = bomb.explode();
-                    if (explosion.h == 0) {
-                        bombIndexes.back() = 1;
-                    } else {
-                        for (i = 0; i < enemies.size();) {
-                            enemyRect = enemies.at(i).get_rect();
-                            if (SDL_HasIntersection(&explosion, &enemyRect) == SDL_TRUE) {
-                                enemies.erase(enemies.begin() + i);
-                            } else {
-                                ++i;
+            PROFILE_COUNTER("enemies", enemies.size());
+            PROFILE_COUNTER("bombs", bombs.size());
+            {
+                PROFILE_ZONE("Game::step bombs");
+                bombs.move(_dt);
+                for (i = 0; i < bombs.size();) {
+                    if (bombs.hits_wall(i, grid.get_walls())) {
+                        flashCount += bombs.is_exploding(i) ? 0 : 1;
+                        explosion = bombs.explode(i, _dt);
+                        if (explosion.h != 0) {
+                            /* A blast whose tiles hold no enemy is skipped without testing any;
+                             * otherwise only the enemies in the cells around it are tested */
+                            bombs.get_blast_area(i, blastArea);
+                            if (blastArea.intersects(enemies.get_occupancy())) {
+                                enemies.find_hits(explosion, enemyHits);
+                                enemies.remove(enemyHits);
                             }
+                        } else if (bombs.get_lifetime(i) <= 0) {
+                            /* The last bomb moves into this slot and is visited next */
+                            bombs.remove(i);
+                            continue;
                         }
                     }
-                }
-            }
-            for (i = 0; i < player.bombs.size();) {
-                if (player.bombs.at(i).exploding && player.bombs.at(i).lifetime > 0) {
-                    if (SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE) < 0) {
-                        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
-                        exit(EXIT_FAILURE);
-                    }
-
-                    explosion = player.bombs.at(i).get_rect();
-                    explosion.x -= tileSize;
-                    explosion.y -= tileSize;
-                    explosion.h *= 3;
-                    explosion.w = explosion.h;
-                    SDL_RenderFillRect(renderer, &explosion);
-                }
-                if (bombIndexes.at(i) && player.bombs.at(i).lifetime <= 0) {
-                    player.bombs.erase(player.bombs.begin() + i);
-                    bombIndexes.erase(bombIndexes.begin() + i);
-                } else {
                     ++i;
                 }
             }
@@ -201,65 +237,32 @@ void Game::step() {
                     _pos = _prevPos;
                 }
                 player.collided_with_wall(_turned, _pos);
-            } else if (enemies.size() == 0) {
+            } else if (enemies.empty() && enemies.get_num_dormant() == 0) {
                 state = State::gameOver;
             }
+
+            if (state == State::playGame) {
+                follow_player();
+            }
             break;
             
         case State::gameOver:
-            SDL_Delay(2000);
-            for (SDL_Event _event; SDL_PollEvent(&_event) != 0;);
+            /* Hold the final frame for a while in simulation time */
+            gameOverTime += _dt;
+            if (gameOverTime < gameOverDelay) {
+                break;
+            }
+            gameOverTime = 0.0;
             keyboard.reset();
-            player.reset(SDL_Point({2, 8}), 5.0 * tileSize, Direction::right);
-            if (enemies.size() == 0) {
+            if (enemies.empty() && enemies.get_num_dormant() == 0) {
                 hud.increment_level();
             }
-            enemies.clear();
-            enemies.emplace_back(Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({7, 7}),
-                3.0 * tileSize,
-                Direction::right
-            ));
-            enemies.emplace_back(Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({7, 8}),
-                3.0 * tileSize,
-                Direction::right
-            ));
-            enemies.emplace_back(Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({8, 7}),
-                3.0 * tileSize,
-                Direction::right
-            ));
-            enemies.emplace_back(Enemy(
-                window,
-                renderer,
-                numRows,
-                numCols,
-                tileSize,
-                grid.get_grid_offset(),
-                SDL_Point({8, 8}),
-                3.0 * tileSize,
-                Direction::right
-            ));
+            /* The board goes back to the spawn first, as spawns are placed on it */
             grid.reset();
+            player.reset(grid.to_board(level.get_player_spawn()), level.get_player_speed() * tileSize, Direction::right);
+            bombs.clear();
+            bombCooldown = 0.0;
+            spawn_enemies();
             state = State::newGame;
             break;
             
@@ -271,11 +274,88 @@ void Game::step() {
     }
 }
 
-void Game::draw() {
-    grid.draw_grid();
-    for (auto& enemy : enemies) {
-        enemy.draw();
+void Game::snapshot(RenderSnapshot& _snapshot) const {
+    _snapshot.sprites.clear();
+    _snapshot.explosions.clear();
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        _snapshot.sprites.push_back({enemies.get_prev_rect(i), enemies.get_rect(i), {0, 255, 255, SDL_ALPHA_OPAQUE}});
     }
-    player.draw();
-    hud.draw();
+    _snapshot.focus = _snapshot.sprites.size();
+    _snapshot.sprites.push_back({player.get_prev_rect(), player.get_rect(), {255, 255, 0, SDL_ALPHA_OPAQUE}});
+    for (size_t i = 0; i < bombs.size(); ++i) {
+        _snapshot.sprites.push_back({bombs.get_prev_rect(i), bombs.get_rect(i), {255, 215, 0, SDL_ALPHA_OPAQUE}});
+        if (bombs.is_exploding(i) && bombs.get_lifetime(i) > 0) {
+            _snapshot.explosions.push_back(bombs.get_blast_rect(i));
+        }
+    }
+    _snapshot.layout = grid.get_layout();
+    _snapshot.layoutVersion = grid.get_layout_version();
+    _snapshot.fruitPos = grid.get_fruit_pos();
+    _snapshot.flashCount = flashCount;
+    _snapshot.level = hud.get_level();
+}
+
+/* Runs on the render thread: everything drawn comes from the snapshot */
+void Game::draw(const RenderSnapshot& _snapshot, double _alpha) {
+    PROFILE_ZONE("Game::draw");
+    /* Headless games have nothing to draw to */
+    if (renderer == nullptr) {
+        return;
+    }
+
+    if (_snapshot.flashCount != drawnFlashCount) {
+        if (SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
+            exit(EXIT_FAILURE);
+        }
+
+        if (SDL_RenderClear(renderer) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_RenderClear() failed: %s", SDL_GetError());
+            exit(EXIT_FAILURE);
+        }
+        drawnFlashCount = _snapshot.flashCount;
+    }
+
+    const RenderSnapshot::Sprite& _focus = _snapshot.sprites[_snapshot.focus];
+    camera.follow(interpolate_rect(_focus.prevRect, _focus.currRect, _alpha), grid.get_scene_size());
+
+    /* Everything below is culled to the camera's view */
+    if (SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+    for (const auto& explosion : _snapshot.explosions) {
+        if (camera.sees(explosion)) {
+            const SDL_Rect _rect = camera.to_screen(explosion);
+            SDL_RenderFillRect(renderer, &_rect);
+        }
+    }
+
+    grid.draw_grid(_snapshot, camera);
+
+    for (const auto& sprite : _snapshot.sprites) {
+        const SDL_Rect _rect = interpolate_rect(sprite.prevRect, sprite.currRect, _alpha);
+        if (!camera.sees(_rect)) {
+            continue;
+        }
+
+        if (SDL_SetRenderDrawColor(renderer, sprite.color.r, sprite.color.g, sprite.color.b, sprite.color.a) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
+            exit(EXIT_FAILURE);
+        }
+
+        const SDL_Rect _screenRect = camera.to_screen(_rect);
+        SDL_RenderFillRect(renderer, &_screenRect);
+    }
+
+    hud.draw(_snapshot.level);
+}
+
+/* Called from the render thread when the renderer drops its render targets */
+void Game::invalidate_render_cache() {
+    grid.invalidate_static_layer();
+}
+
+void Game::shutdown() {
+    grid.shutdown();
 }
@@ -1,27 +1,58 @@
 #include "grid.hpp"
-#include <openssl/rand.h>
-#include <openssl/err.h>
-#include <cstring>
-#include <climits>
+#include "motion.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 
+/* A chunked level is simulated a few chunks at a time, centred on the player */
+static constexpr int windowChunks = 3;
+
 Grid::Grid(
     SDL_Window* _window,
     SDL_Renderer* _renderer,
-    int _numRows,
-    int _numCols,
-    int _tileSize
+    const Level& _level,
+    int _tileSize,
+    Random _random
 ) :
     window(_window),
     renderer(_renderer),
-    numRows(_numRows),
-    numCols(_numCols),
+    level(_level),
+    numRows(level.get_chunk_size() == 0 ? level.get_rows() : calc_board_chunks(level).y * level.get_chunk_size()),
+    numCols(level.get_chunk_size() == 0 ? level.get_cols() : calc_board_chunks(level).x * level.get_chunk_size()),
     tileSize(_tileSize),
-    gridSize(calc_grid_size()), sceneSize(calc_scene_size()), sceneOffset(calc_scene_offset()), gridOffset(calc_grid_offset()),
+    random(_random),
+    /* The board's chunks plus a ring around them, so doubling back is a cache hit */
+    chunks(level, level.get_chunk_size() == 0 ? 0 : (calc_board_chunks(level).x + 2) * (calc_board_chunks(level).y + 2)),
+    origin({0, 0}),
+    prefetchDirection(Direction::none),
+    prefetchOrigin({-1, -1}),
+    gridSize(calc_grid_size()), sceneSize(calc_scene_size()), gridOffset(calc_grid_offset()),
     grid(init_grid()),
     wallRects(calc_wall_rects()),
-    fruitPos(init_fruit())
-{}
+    emptyTiles(),
+    emptySlots(),
+    walls(numRows, numCols),
+    fruits(numRows, numCols),
+    players(numRows, numCols),
+    openNeighbours({
+        Bitboard(numRows, numCols),
+        Bitboard(numRows, numCols),
+        Bitboard(numRows, numCols),
+        Bitboard(numRows, numCols)
+    }),
+    legalMoves(static_cast<size_t>(numRows * numCols), 0),
+    fruitPos({-1, -1}),
+    layout(nullptr),
+    layoutVersion(0),
+    staticLayerSupported(renderer != nullptr),
+    staticLayer(nullptr),
+    staticLayerValid(false),
+    staticLayerVersion(0),
+    staticWallRects()
+{
+    reset();
+}
 
 SDL_Point Grid::calc_grid_size() const {
     return {numCols * tileSize, numRows * tileSize};
@@ -31,36 +62,27 @@ SDL_Point Grid::calc_scene_size() const {
     return {gridSize.x + tileSize * 2, gridSize.y + tileSize * 2};
 }
 
-SDL_Point Grid::calc_scene_offset() const {
-    SDL_Point _windowSize;
-    if (SDL_GetRendererOutputSize(renderer, &_windowSize.x, &_windowSize.y) < 0) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_GetRendererOutputSize() failed: %s", SDL_GetError());
-        exit(EXIT_FAILURE);
-    }
-    
-    return {(_windowSize.x - sceneSize.x) / 2, (_windowSize.y - sceneSize.y) / 2};
-}
-
+/* The scene starts at the origin; the camera decides where it lands in the window */
 SDL_Point Grid::calc_grid_offset() const {
-    return {sceneOffset.x + tileSize, sceneOffset.y + tileSize};
+    return {tileSize, tileSize};
 }
 
 std::vector<SDL_Rect> Grid::calc_wall_rects() const {
    return {
        {
-           sceneOffset.x,
-           sceneOffset.y,
+           0,
+           0,
            sceneSize.x,
            tileSize
        },
        {
-           sceneOffset.x,
+           0,
            gridOffset.y + gridSize.y,
            sceneSize.x,
            tileSize
        },
        {
-           sceneOffset.x,
+           0,
            gridOffset.y,
            tileSize,
            gridSize.y
@@ -74,52 +96,266 @@ std::vector<SDL_Rect> Grid::calc_wall_rects() const {
    };
 }
 
-std::vector<std::vector<Tile>> Grid::init_grid() {
+/* Filled in by load_tiles */
+TileGrid Grid::init_grid() const {
+    return TileGrid(numRows, numCols);
+}
+
+SDL_Point Grid::calc_board_chunks(const Level& _level) {
+    const SDL_Point _numChunks = _level.get_num_chunks();
+    return {std::min(_numChunks.x, windowChunks), std::min(_numChunks.y, windowChunks)};
+}
+
+/* The chunk-aligned world tile at the board's top-left corner that puts
+ * _focus in the middle chunk, clamped to the edges of the level */
+SDL_Point Grid::calc_origin(SDL_Point _focus) const {
+    const int _chunkSize = level.get_chunk_size();
+    if (_chunkSize == 0) {
+        return {0, 0};
+    }
+
+    const SDL_Point _numChunks = level.get_num_chunks();
+    const SDL_Point _boardChunks = {numCols / _chunkSize, numRows / _chunkSize};
     return {
-        { Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::wall, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::player, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::wall, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::wall, Tile::empty, Tile::wall, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::empty, Tile::wall },
-        { Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall, Tile::wall }
+        std::clamp(_focus.x / _chunkSize - _boardChunks.x / 2, 0, _numChunks.x - _boardChunks.x) * _chunkSize,
+        std::clamp(_focus.y / _chunkSize - _boardChunks.y / 2, 0, _numChunks.y - _boardChunks.y) * _chunkSize
     };
 }
 
-SDL_Point Grid::init_fruit() {
-    /* New fruit tile */
-    unsigned int _i;
-    unsigned char _buf[sizeof(_i)];
-    if (RAND_bytes(_buf, sizeof(_buf)) != 1) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "RAND_bytes() failed: %s", ERR_error_string(ERR_get_error(), nullptr));
-        exit(EXIT_FAILURE);
+/* Copies the level's tiles onto the board; a chunked level only brings in
+ * the chunks under the board, going to disk for the ones not cached */
+void Grid::load_tiles(SDL_Point _origin) {
+    origin = _origin;
+    const int _chunkSize = level.get_chunk_size();
+    if (_chunkSize == 0) {
+        grid.assign(numRows, numCols, level.get_tiles());
+        return;
+    }
+
+    PROFILE_ZONE("Grid::load_tiles");
+    for (int _chunkY = 0; _chunkY < numRows / _chunkSize; ++_chunkY) {
+        for (int _chunkX = 0; _chunkX < numCols / _chunkSize; ++_chunkX) {
+            const Tile* _chunk = chunks.get({origin.x / _chunkSize + _chunkX, origin.y / _chunkSize + _chunkY});
+            for (int y = 0; y < _chunkSize; ++y) {
+                std::copy(_chunk + y * _chunkSize, _chunk + (y + 1) * _chunkSize, &grid[{_chunkX * _chunkSize, _chunkY * _chunkSize + y}]);
+            }
+        }
     }
+}
 
-    std::memcpy(&_i, _buf, sizeof(_i));
+/* Hints the OS to read the strip of chunks the board would take in next if
+ * the player keeps going this way; only redone when the board or the
+ * direction changes */
+void Grid::prefetch_ahead(Direction _direction) {
+    if (_direction == prefetchDirection && origin.x == prefetchOrigin.x && origin.y == prefetchOrigin.y) {
+        return;
+    }
+    prefetchDirection = _direction;
+    prefetchOrigin = origin;
+
+    const int _chunkSize = level.get_chunk_size();
+    const SDL_Point _numChunks = level.get_num_chunks();
+    const SDL_Point _first = {origin.x / _chunkSize, origin.y / _chunkSize};
+    const SDL_Point _boardChunks = {numCols / _chunkSize, numRows / _chunkSize};
+    for (int i = 0; i < std::max(_boardChunks.x, _boardChunks.y); ++i) {
+        SDL_Point _chunk;
+        switch (_direction) {
+            case Direction::up:
+                _chunk = {_first.x + i, _first.y - 1};
+                break;
+            case Direction::down:
+                _chunk = {_first.x + i, _first.y + _boardChunks.y};
+                break;
+            case Direction::left:
+                _chunk = {_first.x - 1, _first.y + i};
+                break;
+            case Direction::right:
+                _chunk = {_first.x + _boardChunks.x, _first.y + i};
+                break;
+            default:
+                return;
+        }
 
-    _i = static_cast<unsigned int>(static_cast<double>(_i) / UINT_MAX * (numRows * numCols - 2));
+        if (_chunk.x >= 0 && _chunk.x < _numChunks.x && _chunk.y >= 0 && _chunk.y < _numChunks.y) {
+            chunks.prefetch(_chunk);
+        }
+    }
+}
+
+void Grid::refresh_layout() {
+    layout = std::make_shared<const TileGrid>(grid);
+    ++layoutVersion;
+}
 
-    /* Spawn a new fruit on a new empty tile */
+/* Row-major indices of every empty tile, so a fruit can be placed without
+ * scanning the board. emptySlots maps a tile back to its place in the list
+ * (or -1), which lets set_tile add and remove tiles in constant time. The
+ * wall, fruit and player bitboards mirror the tiles for word-wide queries. */
+void Grid::index_tiles() {
+    emptyTiles.clear();
+    emptySlots.assign(static_cast<size_t>(numRows * numCols), -1);
+    walls.clear();
+    fruits.clear();
+    players.clear();
     for (int y = 0; y < numRows; ++y) {
         for (int x = 0; x < numCols; ++x) {
-            if (grid.at(y).at(x) == Tile::empty && _i-- == 0) {
-                fruitPos = SDL_Point{x, y};
-                grid.at(fruitPos.y).at(fruitPos.x) = Tile::fruit;
-                return fruitPos;
+            const Tile _tile = grid[{x, y}];
+            if (_tile == Tile::empty) {
+                emptySlots[y * numCols + x] = static_cast<int>(emptyTiles.size());
+                emptyTiles.push_back(y * numCols + x);
+            } else if (Bitboard* _board = get_board(_tile); _board != nullptr) {
+                _board->set({x, y});
             }
         }
     }
+    update_open_neighbours();
+    update_legal_moves({0, 0, numCols, numRows});
+}
 
-    return fruitPos;
+/* openNeighbours[d] holds the tiles whose neighbour in direction d is not a wall */
+void Grid::update_open_neighbours() {
+    for (const Direction _direction : {Direction::up, Direction::down, Direction::left, Direction::right}) {
+        Bitboard& _open = openNeighbours[static_cast<int>(_direction) - 1];
+        _open = walls;
+        _open.invert();
+        switch (_direction) {
+            case Direction::up:
+                _open.shift(Direction::down);
+                break;
+            case Direction::down:
+                _open.shift(Direction::up);
+                break;
+            case Direction::left:
+                _open.shift(Direction::right);
+                break;
+            case Direction::right:
+                _open.shift(Direction::left);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Only the four neighbours' bits facing _position depend on whether it is a
+ * wall, so a single wall change patches those instead of shifting every board */
+void Grid::update_open_neighbours(SDL_Point _position) {
+    const bool _open = !walls.test(_position);
+    for (const Direction _direction : {Direction::up, Direction::down, Direction::left, Direction::right}) {
+        /* The neighbour that looks back at _position in _direction */
+        const SDL_Point _neighbour = {
+            _position.x - MotionTable::stepX[static_cast<int>(_direction)],
+            _position.y - MotionTable::stepY[static_cast<int>(_direction)]
+        };
+        if (!grid.contains(_neighbour)) {
+            continue;
+        }
+
+        Bitboard& _board = openNeighbours[static_cast<int>(_direction) - 1];
+        if (_open) {
+            _board.set(_neighbour);
+        } else {
+            _board.reset(_neighbour);
+        }
+    }
+}
+
+/* legalMoves caches the open directions of every tile so an enemy's turn is
+ * one load; a wall only changes its own mask and those of its neighbours */
+void Grid::update_legal_moves(const SDL_Rect& _area) {
+    const int _left = std::max(0, _area.x);
+    const int _top = std::max(0, _area.y);
+    const int _right = std::min(numCols, _area.x + _area.w);
+    const int _bottom = std::min(numRows, _area.y + _area.h);
+    for (int y = _top; y < _bottom; ++y) {
+        for (int x = _left; x < _right; ++x) {
+            std::uint8_t _moves = 0;
+            for (const Direction _direction : {Direction::up, Direction::down, Direction::left, Direction::right}) {
+                if (openNeighbours[static_cast<int>(_direction) - 1].test({x, y})) {
+                    _moves |= 1u << static_cast<int>(_direction);
+                }
+            }
+            legalMoves[y * numCols + x] = _moves;
+        }
+    }
+}
+
+Bitboard* Grid::get_board(Tile _tile) {
+    switch (_tile) {
+        case Tile::wall:
+            return &walls;
+        case Tile::fruit:
+            return &fruits;
+        case Tile::player:
+            return &players;
+        default:
+            return nullptr;
+    }
+}
+
+void Grid::set_tile(SDL_Point _position, Tile _tile) {
+    Tile& _currTile = grid[_position];
+    if (_currTile == _tile) {
+        return;
+    }
+
+    const int _index = _position.y * numCols + _position.x;
+    if (_currTile == Tile::empty) {
+        /* Swap the last empty tile into this one's slot */
+        const int _slot = emptySlots[_index];
+        emptyTiles[_slot] = emptyTiles.back();
+        emptySlots[emptyTiles[_slot]] = _slot;
+        emptyTiles.pop_back();
+        emptySlots[_index] = -1;
+    } else if (_tile == Tile::empty) {
+        emptySlots[_index] = static_cast<int>(emptyTiles.size());
+        emptyTiles.push_back(_index);
+    }
+
+    if (Bitboard* _board = get_board(_currTile); _board != nullptr) {
+        _board->reset(_position);
+    }
+    if (Bitboard* _board = get_board(_tile); _board != nullptr) {
+        _board->set(_position);
+    }
+
+    const bool _wallChanged = _currTile == Tile::wall || _tile == Tile::wall;
+    _currTile = _tile;
+    if (_wallChanged) {
+        update_open_neighbours(_position);
+        update_legal_moves({_position.x - 1, _position.y - 1, 3, 3});
+    }
+}
+
+/* Returns {-1, -1} when there is no empty tile left */
+SDL_Point Grid::init_fruit() {
+    if (emptyTiles.empty()) {
+        return {-1, -1};
+    }
+
+    /* New fruit tile */
+    const int _index = emptyTiles[random.below(static_cast<std::uint32_t>(emptyTiles.size()))];
+    const SDL_Point _fruitPos = {_index % numCols, _index / numCols};
+    set_tile(_fruitPos, Tile::fruit);
+
+    return _fruitPos;
+}
+
+int Grid::get_rows() const {
+    return numRows;
+}
+
+int Grid::get_cols() const {
+    return numCols;
+}
+
+bool Grid::contains(SDL_Point _position) const {
+    return grid.contains(_position);
+}
+
+/* Board positions are relative to the level's tile at origin */
+SDL_Point Grid::to_board(SDL_Point _world) const {
+    return {_world.x - origin.x, _world.y - origin.y};
 }
 
 SDL_Point Grid::get_grid_size() const {
@@ -130,21 +366,47 @@ SDL_Point Grid::get_scene_size() const {
     return sceneSize;
 }
 
-SDL_Point Grid::get_scene_offset() const {
-    return sceneOffset;
-}
-
 SDL_Point Grid::get_grid_offset() const {
     return gridOffset;
 }
 
+SDL_Point Grid::get_fruit_pos() const {
+    return fruitPos;
+}
+
+const Bitboard& Grid::get_walls() const {
+    return walls;
+}
+
+const Bitboard& Grid::get_fruits() const {
+    return fruits;
+}
+
+const Bitboard& Grid::get_players() const {
+    return players;
+}
+
+/* Immutable copy of the tiles, replaced whenever the walls change, so the
+ * render thread can keep drawing one while the simulation moves on */
+std::shared_ptr<const TileGrid> Grid::get_layout() const {
+    return layout;
+}
+
+unsigned int Grid::get_layout_version() const {
+    return layoutVersion;
+}
+
+/* Each miss is one chunk read from the level */
+unsigned long Grid::get_chunk_misses() const {
+    return chunks.get_misses();
+}
+
 /* TODO: Perhaps Grid::update should take a list of players
  * and enemies with their respective actions for a given
  * frame, and internally resolve the game logic. Currently,
  * Grid::update assumes the player is the only entity in the game. */
 int Grid::update(SDL_Point _prevPos, SDL_Point _currPos) {
-    auto& currTile = grid.at(_currPos.y).at(_currPos.x);
-    auto& prevTile = grid.at(_prevPos.y).at(_prevPos.x);
+    const Tile currTile = grid[_currPos];
     
     /* If position is same, do nothing */
     if (_currPos.x == _prevPos.x && _currPos.y == _prevPos.y) {
@@ -164,89 +426,262 @@ int Grid::update(SDL_Point _prevPos, SDL_Point _currPos) {
 
     /* Empty tile */
     if (currTile == Tile::empty) {
-        currTile = Tile::player;
-        prevTile = Tile::empty;
+        set_tile(_currPos, Tile::player);
+        set_tile(_prevPos, Tile::empty);
         return 0;
     }
 
     /* Fruit tile */
     if (currTile == Tile::fruit) {
-        currTile = Tile::player;
-
-        /* New fruit tile */
-        unsigned int _i;
-        unsigned char _buf[sizeof(_i)];
-        if (RAND_bytes(_buf, sizeof(_buf)) != 1) {
-            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "RAND_bytes() failed: %s", ERR_error_string(ERR_get_error(), nullptr));
-            exit(EXIT_FAILURE);
+        set_tile(_currPos, Tile::player);
+
+        /* Spawn a new fruit on a new empty tile */
+        fruitPos = init_fruit();
+        if (fruitPos.x < 0) {
+            /* Unable to spawn a fruit location */
+            return -1;
         }
 
-        std::memcpy(&_i, _buf, sizeof(_i));
+        set_tile(_prevPos, Tile::empty);
+        return 0;
+    }
+
+    return 0;
+}
 
-        _i = static_cast<unsigned int>(static_cast<double>(_i) / UINT_MAX * (256 - 154 - 2));
+/* Keeps a chunked level's board centred on the player. When the player
+ * crosses into another chunk the board moves by whole chunks, keeping the
+ * player and fruit, and the shift in tiles is returned so entities can be
+ * moved with it; otherwise it returns {0, 0}. */
+SDL_Point Grid::follow(SDL_Point _playerPos, Direction _direction) {
+    if (level.get_chunk_size() == 0) {
+        return {0, 0};
+    }
 
-        /* Spawn a new fruit on a new empty tile */
-        for (int y = 0; y < numRows; ++y) {
-            for (int x = 0; x < numCols; ++x) {
-                if (grid.at(y).at(x) == Tile::empty && _i-- == 0) {
-                    fruitPos = SDL_Point{x, y};
-                    grid.at(fruitPos.y).at(fruitPos.x) = Tile::fruit;
-                    prevTile = Tile::empty;
-                    return 0;
-                }
+    /* Half a chunk of slack around the middle chunk, so walking back and
+     * forth over a chunk edge does not move the board every time */
+    const int _chunkSize = level.get_chunk_size();
+    const SDL_Point _middle = {numCols / _chunkSize / 2 * _chunkSize, numRows / _chunkSize / 2 * _chunkSize};
+    const bool _nearMiddle =
+        _playerPos.x >= _middle.x - _chunkSize / 2 && _playerPos.x < _middle.x + _chunkSize + _chunkSize / 2 &&
+        _playerPos.y >= _middle.y - _chunkSize / 2 && _playerPos.y < _middle.y + _chunkSize + _chunkSize / 2;
+
+    const SDL_Point _playerWorld = {_playerPos.x + origin.x, _playerPos.y + origin.y};
+    const SDL_Point _origin = calc_origin(_playerWorld);
+    if (_nearMiddle || (_origin.x == origin.x && _origin.y == origin.y)) {
+        prefetch_ahead(_direction);
+        return {0, 0};
+    }
+
+    PROFILE_ZONE("Grid::follow");
+    const SDL_Point _shift = {_origin.x - origin.x, _origin.y - origin.y};
+    const SDL_Point _fruitWorld = {fruitPos.x + origin.x, fruitPos.y + origin.y};
+    const bool _hadFruit = fruitPos.x >= 0;
+    load_tiles(_origin);
+
+    /* The spawn tile in the level is only where the player starts */
+    if (const SDL_Point _spawn = to_board(level.get_player_spawn()); grid.contains(_spawn)) {
+        grid[_spawn] = Tile::empty;
+    }
+    grid[to_board(_playerWorld)] = Tile::player;
+
+    fruitPos = to_board(_fruitWorld);
+    const bool _keepFruit = _hadFruit && grid.contains(fruitPos) && grid[fruitPos] == Tile::empty;
+    if (_keepFruit) {
+        grid[fruitPos] = Tile::fruit;
+    }
+    index_tiles();
+    if (!_keepFruit) {
+        fruitPos = init_fruit();
+    }
+
+    refresh_layout();
+    prefetch_ahead(_direction);
+    return _shift;
+}
+
+/* The grid lines and walls only change on reset, so they are drawn once into
+ * a target texture and copied each frame. Renderers without target texture
+ * support fall back to drawing them directly. */
+void Grid::draw_grid(const RenderSnapshot& _snapshot, const Camera& _camera) {
+    PROFILE_ZONE("Grid::draw_grid");
+    if (_snapshot.layout == nullptr) {
+        return;
+    }
+
+    if (staticLayer == nullptr && staticLayerSupported) {
+        staticLayer = init_static_layer();
+        staticLayerSupported = staticLayer != nullptr;
+    }
+
+    /* Only the tiles overlapping the view are drawn or copied */
+    const SDL_Rect& _view = _camera.get_view();
+    const SDL_Rect _tiles = {
+        std::clamp((_view.x - gridOffset.x) / tileSize, 0, numCols),
+        std::clamp((_view.y - gridOffset.y) / tileSize, 0, numRows),
+        0,
+        0
+    };
+    const SDL_Rect _visible = {
+        _tiles.x,
+        _tiles.y,
+        std::clamp((_view.x + _view.w - gridOffset.x + tileSize - 1) / tileSize, 0, numCols) - _tiles.x,
+        std::clamp((_view.y + _view.h - gridOffset.y + tileSize - 1) / tileSize, 0, numRows) - _tiles.y
+    };
+
+    if (staticLayer == nullptr) {
+        if (_visible.w > 0 && _visible.h > 0) {
+            draw_static_layer(*_snapshot.layout, _camera.to_screen(gridOffset), _visible);
+        }
+    } else {
+        if (!staticLayerValid || staticLayerVersion != _snapshot.layoutVersion) {
+            if (SDL_SetRenderTarget(renderer, staticLayer) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderTarget() failed: %s", SDL_GetError());
+                exit(EXIT_FAILURE);
             }
+
+            if (SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
+                exit(EXIT_FAILURE);
+            }
+
+            if (SDL_RenderClear(renderer) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_RenderClear() failed: %s", SDL_GetError());
+                exit(EXIT_FAILURE);
+            }
+
+            draw_static_layer(*_snapshot.layout, {0, 0}, {0, 0, numCols, numRows});
+
+            if (SDL_SetRenderTarget(renderer, nullptr) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderTarget() failed: %s", SDL_GetError());
+                exit(EXIT_FAILURE);
+            }
+            staticLayerVersion = _snapshot.layoutVersion;
+            staticLayerValid = true;
         }
 
-        /* Unable to spawn a fruit location */
-        return -1;
+        const SDL_Rect _layerRect = {gridOffset.x, gridOffset.y, gridSize.x + 1, gridSize.y + 1};
+        SDL_Rect _rect;
+        if (SDL_IntersectRect(&_layerRect, &_view, &_rect) == SDL_TRUE) {
+            const SDL_Rect _source = {_rect.x - gridOffset.x, _rect.y - gridOffset.y, _rect.w, _rect.h};
+            _rect = _camera.to_screen(_rect);
+            if (SDL_RenderCopy(renderer, staticLayer, &_source, &_rect) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_RenderCopy() failed: %s", SDL_GetError());
+                exit(EXIT_FAILURE);
+            }
+        }
     }
 
-    return 0;
+    if (_snapshot.fruitPos.x >= 0) {
+        draw_tile(_snapshot.fruitPos, Tile::fruit, _camera);
+    }
 }
 
-void Grid::draw_grid() {
+SDL_Texture* Grid::init_static_layer() {
+    SDL_RendererInfo _info;
+    if (SDL_GetRendererInfo(renderer, &_info) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_GetRendererInfo() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    if ((_info.flags & SDL_RENDERER_TARGETTEXTURE) == 0) {
+        return nullptr;
+    }
+
+    /* A zero maximum means the renderer does not report one */
+    if ((_info.max_texture_width > 0 && gridSize.x + 1 > _info.max_texture_width) || (_info.max_texture_height > 0 && gridSize.y + 1 > _info.max_texture_height)) {
+        return nullptr;
+    }
+
+    /* Past a few screens of pixels, drawing the visible tiles each frame is
+     * cheaper than keeping the whole board in video memory */
+    SDL_Point _windowSize;
+    if (SDL_GetRendererOutputSize(renderer, &_windowSize.x, &_windowSize.y) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_GetRendererOutputSize() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+    if (static_cast<long>(gridSize.x + 1) * (gridSize.y + 1) > 4L * _windowSize.x * _windowSize.y) {
+        return nullptr;
+    }
+
+    /* One pixel wider and taller than the grid for the closing grid lines */
+    SDL_Texture* _texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, gridSize.x + 1, gridSize.y + 1);
+    if (_texture == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_CreateTexture() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    if (SDL_SetTextureBlendMode(_texture, SDL_BLENDMODE_BLEND) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetTextureBlendMode() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    return _texture;
+}
+
+/* Draws the grid lines and walls of the block of _tiles (in tiles), with
+ * the grid's top-left corner at _origin */
+void Grid::draw_static_layer(const TileGrid& _layout, SDL_Point _origin, const SDL_Rect& _tiles) {
     if (SDL_SetRenderDrawColor(renderer, 0, 255, 0, SDL_ALPHA_OPAQUE) < 0) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
         exit(EXIT_FAILURE);
     }
     
-    for (int i = 0; i <= numRows; ++i) {
+    for (int i = _tiles.y; i <= _tiles.y + _tiles.h; ++i) {
         SDL_RenderDrawLine(renderer,
-            gridOffset.x,
-            gridOffset.y + tileSize * i,
-            gridOffset.x + gridSize.x,
-            gridOffset.y + tileSize * i
+            _origin.x + tileSize * _tiles.x,
+            _origin.y + tileSize * i,
+            _origin.x + tileSize * (_tiles.x + _tiles.w),
+            _origin.y + tileSize * i
         );
     }
     
-    for (int i = 0; i <= numCols; ++i) {
+    for (int i = _tiles.x; i <= _tiles.x + _tiles.w; ++i) {
         SDL_RenderDrawLine(renderer,
-            gridOffset.x + tileSize * i,
-            gridOffset.y,
-            gridOffset.x + tileSize * i,
-            gridOffset.y + gridSize.y
+            _origin.x + tileSize * i,
+            _origin.y + tileSize * _tiles.y,
+            _origin.x + tileSize * i,
+            _origin.y + tileSize * (_tiles.y + _tiles.h)
         );
     }
 
-    for (int y = 0; y < numRows; ++y) {
-        for (int x = 0; x < numCols; ++x) {
-            draw_tile({x, y}, grid.at(y).at(x));
+    staticWallRects.clear();
+    for (int y = _tiles.y; y < _tiles.y + _tiles.h; ++y) {
+        for (int x = _tiles.x; x < _tiles.x + _tiles.w; ++x) {
+            if (_layout[{x, y}] == Tile::wall) {
+                staticWallRects.push_back({_origin.x + x * tileSize, _origin.y + y * tileSize, tileSize, tileSize});
+            }
         }
     }
+
+    if (SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    SDL_RenderFillRects(renderer, staticWallRects.data(), static_cast<int>(staticWallRects.size()));
 }
 
-void Grid::draw_walls() {
+/* Render targets can lose their contents, e.g. when the device is reset */
+void Grid::invalidate_static_layer() {
+    staticLayerValid = false;
+}
+
+void Grid::draw_walls(const Camera& _camera) {
     if (SDL_SetRenderDrawColor(renderer, 0, 0, 255, SDL_ALPHA_OPAQUE) < 0) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
         exit(EXIT_FAILURE);
     }
 
     for (const auto& wallRect : wallRects) {
-        SDL_RenderFillRect(renderer, &wallRect);
+        if (_camera.sees(wallRect)) {
+            const SDL_Rect _rect = _camera.to_screen(wallRect);
+            SDL_RenderFillRect(renderer, &_rect);
+        }
     }
 }
 
-void Grid::draw_tile(const SDL_Point& tilePosition, const Tile& tileType) {
+void Grid::draw_tile(const SDL_Point& tilePosition, const Tile& tileType, const Camera& _camera) {
     int r, g, b;
     switch (tileType) {
         case Tile::fruit:
@@ -264,16 +699,30 @@ void Grid::draw_tile(const SDL_Point& tilePosition, const Tile& tileType) {
         exit(EXIT_FAILURE);
     }
 
-    SDL_Rect _rect = {
+    const SDL_Rect _rect = {
         gridOffset.x + tilePosition.x * tileSize,
         gridOffset.y + tilePosition.y * tileSize,
         tileSize,
         tileSize
     };
-    SDL_RenderFillRect(renderer, &_rect);
+    if (!_camera.sees(_rect)) {
+        return;
+    }
+
+    const SDL_Rect _screenRect = _camera.to_screen(_rect);
+    SDL_RenderFillRect(renderer, &_screenRect);
 }
 
 void Grid::reset() {
-    grid = init_grid();
+    load_tiles(calc_origin(level.get_player_spawn()));
+    index_tiles();
     fruitPos = init_fruit();
+    refresh_layout();
+}
+
+void Grid::shutdown() {
+    if (staticLayer != nullptr) {
+        SDL_DestroyTexture(staticLayer);
+        staticLayer = nullptr;
+    }
 }
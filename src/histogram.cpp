@@ -0,0 +1,80 @@
+#include "histogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+Histogram::Histogram() :
+    buckets(),
+    count(0),
+    max(0),
+    sum(0)
+{}
+
+int Histogram::bucket_index(std::uint64_t _value) {
+    if (_value < subBucketCount) {
+        return static_cast<int>(_value);
+    }
+
+    /* Keep the top subBucketBits + 1 bits: the leading one picks the octave, the rest the sub-bucket */
+    const int _shift = std::bit_width(_value) - 1 - subBucketBits;
+    return subBucketCount + _shift * subBucketCount + static_cast<int>((_value >> _shift) - subBucketCount);
+}
+
+std::uint64_t Histogram::bucket_midpoint(int _index) {
+    if (_index < subBucketCount) {
+        return _index;
+    }
+
+    const int _shift = (_index - subBucketCount) / subBucketCount;
+    const std::uint64_t _lower = static_cast<std::uint64_t>(subBucketCount + (_index - subBucketCount) % subBucketCount) << _shift;
+    return _lower + ((std::uint64_t{1} << _shift) >> 1);
+}
+
+void Histogram::record(std::int64_t _ns) {
+    _ns = std::max<std::int64_t>(_ns, 0);
+    buckets[bucket_index(static_cast<std::uint64_t>(_ns))].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(_ns, std::memory_order_relaxed);
+    for (std::int64_t _max = max.load(std::memory_order_relaxed); _ns > _max && !max.compare_exchange_weak(_max, _ns, std::memory_order_relaxed););
+}
+
+void Histogram::reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::get_count() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+std::int64_t Histogram::get_max() const {
+    return max.load(std::memory_order_relaxed);
+}
+
+double Histogram::get_mean() const {
+    const std::uint64_t _count = get_count();
+    return _count > 0 ? static_cast<double>(sum.load(std::memory_order_relaxed)) / _count : 0.0;
+}
+
+std::int64_t Histogram::get_percentile(double _percentile) const {
+    const std::uint64_t _count = get_count();
+    if (_count == 0) {
+        return 0;
+    }
+
+    /* Rank of the sample at or below which _percentile percent of samples fall */
+    const auto _rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(_percentile / 100.0 * _count)));
+    std::uint64_t _seen = 0;
+    for (int i = 0; i < bucketCount; ++i) {
+        _seen += buckets[i].load(std::memory_order_relaxed);
+        if (_seen >= _rank) {
+            return std::min(static_cast<std::int64_t>(bucket_midpoint(i)), get_max());
+        }
+    }
+
+    return get_max();
+}
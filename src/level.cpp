@@ -0,0 +1,400 @@
+#include "defaultlevel.hpp"
+#include "level.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static constexpr char levelMagic[4] = {'P', 'M', 'L', 'V'};
+static constexpr std::uint16_t levelVersion = 2;
+static constexpr int maxChunkSize = 1024;
+static constexpr std::uint32_t maxSide = 1 << 16;
+
+Level::Level() :
+    bytes(defaultLevel),
+    mappedSize(0),
+    fileSize(sizeof(defaultLevel)),
+    file(-1),
+    header(nullptr),
+    enemySpawns(nullptr),
+    tiles(nullptr)
+{
+    init_view("built-in level");
+}
+
+Level::Level(const std::string& _path) :
+    bytes(nullptr),
+    mappedSize(0),
+    fileSize(0),
+    file(-1),
+    header(nullptr),
+    enemySpawns(nullptr),
+    tiles(nullptr)
+{
+    file = open(_path.c_str(), O_RDONLY);
+    if (file < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "open() failed: %s: %s", _path.c_str(), std::strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    struct stat _stat;
+    if (fstat(file, &_stat) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "fstat() failed: %s: %s", _path.c_str(), std::strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    fileSize = static_cast<size_t>(_stat.st_size);
+
+    /* A chunked level only needs its header and spawns mapped */
+    LevelHeader _header;
+    if (fileSize < sizeof(LevelHeader) || pread(file, &_header, sizeof(_header), 0) != static_cast<ssize_t>(sizeof(_header))) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s is not a level file", _path.c_str());
+        exit(EXIT_FAILURE);
+    }
+    mappedSize = fileSize;
+    if (_header.chunkSize != 0) {
+        mappedSize = std::min(fileSize, sizeof(LevelHeader) + static_cast<size_t>(_header.numEnemySpawns) * sizeof(LevelSpawn));
+    }
+
+    void* _map = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, file, 0);
+    if (_map == MAP_FAILED) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "mmap() failed: %s: %s", _path.c_str(), std::strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    bytes = static_cast<const unsigned char*>(_map);
+    if (_header.chunkSize == 0) {
+        close(file);
+        file = -1;
+    }
+
+    init_view(_path.c_str());
+}
+
+Level::~Level() {
+    if (mappedSize != 0) {
+        munmap(const_cast<unsigned char*>(bytes), mappedSize);
+    }
+    if (file >= 0) {
+        close(file);
+    }
+}
+
+/* Points the header, spawn table and tiles into the bytes after checking
+ * that they describe a whole, playable level */
+void Level::init_view(const char* _source) {
+    header = reinterpret_cast<const LevelHeader*>(bytes);
+    if (std::memcmp(header->magic, levelMagic, sizeof(levelMagic)) != 0 || header->version != levelVersion) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s is not a version %d level file", _source, levelVersion);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Board sizes and tile indices are ints, and an unchunked level is held whole */
+    const size_t _tilesSize = static_cast<size_t>(header->rows) * header->cols;
+    if (header->rows == 0 || header->cols == 0 || header->rows > maxSide || header->cols > maxSide || (header->chunkSize == 0 && _tilesSize > INT_MAX)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s has an unsupported size of %u x %u tiles", _source, header->rows, header->cols);
+        exit(EXIT_FAILURE);
+    }
+    if (header->chunkSize != 0 && (header->chunkSize > maxChunkSize || header->rows % header->chunkSize != 0 || header->cols % header->chunkSize != 0)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s has chunks of %u tiles, which do not evenly tile its map", _source, header->chunkSize);
+        exit(EXIT_FAILURE);
+    }
+
+    const size_t _tilesOffset = sizeof(LevelHeader) + static_cast<size_t>(header->numEnemySpawns) * sizeof(LevelSpawn);
+    if (fileSize != _tilesOffset + _tilesSize) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s is truncated or has the wrong size", _source);
+        exit(EXIT_FAILURE);
+    }
+
+    enemySpawns = reinterpret_cast<const LevelSpawn*>(bytes + sizeof(LevelHeader));
+
+    /* Chunks are checked as they are read */
+    if (header->chunkSize == 0) {
+        tiles = reinterpret_cast<const Tile*>(bytes + _tilesOffset);
+        for (size_t i = 0; i < _tilesSize; ++i) {
+            if (static_cast<std::uint8_t>(tiles[i]) > static_cast<std::uint8_t>(Tile::fruit)) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s has an unknown tile at %zu", _source, i);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    const auto _inside = [this](const LevelSpawn& _spawn) {
+        return _spawn.x < header->cols && _spawn.y < header->rows;
+    };
+    bool _spawnsInside = _inside(header->playerSpawn);
+    for (std::uint32_t i = 0; i < header->numEnemySpawns; ++i) {
+        _spawnsInside = _spawnsInside && _inside(enemySpawns[i]);
+    }
+    if (!_spawnsInside) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s has a spawn point outside the grid", _source);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Skips blank lines and ';' comments */
+static bool next_line(std::istream& _text, std::string& _line, int& _lineNumber) {
+    while (std::getline(_text, _line)) {
+        ++_lineNumber;
+        if (!_line.empty() && _line.back() == '\r') {
+            _line.pop_back();
+        }
+        if (!_line.empty() && _line[0] != ';') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool to_tile(char _symbol, Tile& _tile) {
+    switch (_symbol) {
+        case '#':
+            _tile = Tile::wall;
+            return true;
+        case '.':
+        case 'E':
+            _tile = Tile::empty;
+            return true;
+        case 'P':
+            _tile = Tile::player;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* The text format is a few "key value" lines (name, player_speed,
+ * enemy_speed, bomb_speed, chunk_size) and then a "map" line followed by one
+ * line per row: '#' is a wall, '.' is empty, 'P' is the player's spawn and
+ * 'E' an enemy's. Lines starting with ';' are comments. The map is read
+ * twice, once for its size and spawns and once to write the tiles, so
+ * levels far larger than memory convert one band of chunks at a time. */
+void Level::convert(const std::string& _textPath, const std::string& _levelPath) {
+    std::ifstream _text(_textPath);
+    if (!_text) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not open %s", _textPath.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    LevelHeader _header{};
+    std::memcpy(_header.magic, levelMagic, sizeof(levelMagic));
+    _header.version = levelVersion;
+    _header.playerSpeed = 5.0f;
+    _header.enemySpeed = 3.0f;
+    _header.bombSpeed = 7.0f;
+
+    std::string _line;
+    int _lineNumber = 0;
+    bool _inMap = false;
+    while (!_inMap && next_line(_text, _line, _lineNumber)) {
+        std::istringstream _fields(_line);
+        std::string _key;
+        _fields >> _key;
+        if (_key == "map") {
+            _inMap = true;
+        } else if (_key == "name") {
+            std::string _name;
+            std::getline(_fields >> std::ws, _name);
+            /* Leaves at least one zero byte, so the name always ends */
+            std::memcpy(_header.name, _name.c_str(), std::min(_name.size(), sizeof(_header.name) - 1));
+        } else if (_key == "player_speed") {
+            _fields >> _header.playerSpeed;
+        } else if (_key == "enemy_speed") {
+            _fields >> _header.enemySpeed;
+        } else if (_key == "bomb_speed") {
+            _fields >> _header.bombSpeed;
+        } else if (_key == "chunk_size") {
+            _fields >> _header.chunkSize;
+            if (_header.chunkSize == 0 || _header.chunkSize > maxChunkSize) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s:%d: chunk_size must be 1 to %d", _textPath.c_str(), _lineNumber, maxChunkSize);
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s:%d: unknown key %s", _textPath.c_str(), _lineNumber, _key.c_str());
+            exit(EXIT_FAILURE);
+        }
+        if (_fields.fail()) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s:%d: bad value for %s", _textPath.c_str(), _lineNumber, _key.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+    const std::streampos _mapStart = _text.tellg();
+    const int _mapLineNumber = _lineNumber;
+
+    /* First pass: size and spawns */
+    std::vector<LevelSpawn> _enemySpawns;
+    bool _hasPlayer = false;
+    while (_inMap && next_line(_text, _line, _lineNumber)) {
+        if (_header.rows == 0) {
+            _header.cols = static_cast<std::uint32_t>(_line.size());
+        } else if (_line.size() != _header.cols) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s:%d: every row must be %u tiles wide", _textPath.c_str(), _lineNumber, _header.cols);
+            exit(EXIT_FAILURE);
+        }
+
+        for (size_t x = 0; x < _line.size(); ++x) {
+            Tile _tile;
+            if (!to_tile(_line[x], _tile)) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s:%d: unknown tile '%c'", _textPath.c_str(), _lineNumber, _line[x]);
+                exit(EXIT_FAILURE);
+            }
+
+            const LevelSpawn _spawn = {static_cast<std::uint32_t>(x), _header.rows};
+            if (_line[x] == 'E') {
+                _enemySpawns.push_back(_spawn);
+            } else if (_line[x] == 'P') {
+                if (_hasPlayer) {
+                    SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s:%d: more than one player spawn", _textPath.c_str(), _lineNumber);
+                    exit(EXIT_FAILURE);
+                }
+                _header.playerSpawn = _spawn;
+                _hasPlayer = true;
+            }
+        }
+        ++_header.rows;
+    }
+
+    if (_header.rows == 0 || !_hasPlayer) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s needs a map with a player spawn", _textPath.c_str());
+        exit(EXIT_FAILURE);
+    }
+    if (_header.rows > maxSide || _header.cols > maxSide || (_header.chunkSize == 0 && static_cast<size_t>(_header.rows) * _header.cols > INT_MAX)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s is too large; add a chunk_size line, or keep each side at most %u tiles", _textPath.c_str(), maxSide);
+        exit(EXIT_FAILURE);
+    }
+    if (_header.chunkSize != 0 && (_header.rows % _header.chunkSize != 0 || _header.cols % _header.chunkSize != 0)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s: the map's %u x %u tiles must be a multiple of chunk_size %u", _textPath.c_str(), _header.rows, _header.cols, _header.chunkSize);
+        exit(EXIT_FAILURE);
+    }
+    _header.numEnemySpawns = static_cast<std::uint32_t>(_enemySpawns.size());
+
+    std::ofstream _level(_levelPath, std::ios::binary);
+    _level.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+    _level.write(reinterpret_cast<const char*>(_enemySpawns.data()), static_cast<std::streamsize>(_enemySpawns.size() * sizeof(LevelSpawn)));
+
+    /* Second pass: tiles, one band of chunkSize rows at a time */
+    _text.clear();
+    _text.seekg(_mapStart);
+    _lineNumber = _mapLineNumber;
+    const int _bandRows = _header.chunkSize == 0 ? 1 : _header.chunkSize;
+    const int _bandCols = static_cast<int>(_header.cols);
+    std::vector<Tile> _band(static_cast<size_t>(_bandRows) * _bandCols);
+    for (std::uint32_t _row = 0; _row < _header.rows; _row += _bandRows) {
+        for (int y = 0; y < _bandRows && next_line(_text, _line, _lineNumber); ++y) {
+            for (size_t x = 0; x < _line.size(); ++x) {
+                to_tile(_line[x], _band[y * _bandCols + x]);
+            }
+        }
+
+        if (_header.chunkSize == 0) {
+            _level.write(reinterpret_cast<const char*>(_band.data()), static_cast<std::streamsize>(_band.size()));
+            continue;
+        }
+        for (int _chunkX = 0; _chunkX < _bandCols; _chunkX += _bandRows) {
+            for (int y = 0; y < _bandRows; ++y) {
+                _level.write(reinterpret_cast<const char*>(&_band[y * _bandCols + _chunkX]), _bandRows);
+            }
+        }
+    }
+
+    if (!_level) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not write %s", _levelPath.c_str());
+        exit(EXIT_FAILURE);
+    }
+}
+
+std::string_view Level::get_name() const {
+    return std::string_view(header->name, strnlen(header->name, sizeof(header->name)));
+}
+
+int Level::get_rows() const {
+    return static_cast<int>(header->rows);
+}
+
+int Level::get_cols() const {
+    return static_cast<int>(header->cols);
+}
+
+const Tile* Level::get_tiles() const {
+    return tiles;
+}
+
+SDL_Point Level::get_player_spawn() const {
+    return {static_cast<int>(header->playerSpawn.x), static_cast<int>(header->playerSpawn.y)};
+}
+
+double Level::get_player_speed() const {
+    return header->playerSpeed;
+}
+
+int Level::get_num_enemy_spawns() const {
+    return static_cast<int>(header->numEnemySpawns);
+}
+
+SDL_Point Level::get_enemy_spawn(int _index) const {
+    return {static_cast<int>(enemySpawns[_index].x), static_cast<int>(enemySpawns[_index].y)};
+}
+
+double Level::get_enemy_speed() const {
+    return header->enemySpeed;
+}
+
+double Level::get_bomb_speed() const {
+    return header->bombSpeed;
+}
+
+int Level::get_chunk_size() const {
+    return header->chunkSize;
+}
+
+SDL_Point Level::get_num_chunks() const {
+    if (header->chunkSize == 0) {
+        return {1, 1};
+    }
+
+    return {
+        static_cast<int>(header->cols / header->chunkSize),
+        static_cast<int>(header->rows / header->chunkSize)
+    };
+}
+
+size_t Level::get_chunk_offset(SDL_Point _chunk) const {
+    const size_t _chunkBytes = static_cast<size_t>(header->chunkSize) * header->chunkSize;
+    const size_t _index = static_cast<size_t>(_chunk.y) * get_num_chunks().x + _chunk.x;
+    return sizeof(LevelHeader) + static_cast<size_t>(header->numEnemySpawns) * sizeof(LevelSpawn) + _index * _chunkBytes;
+}
+
+/* Fills chunkSize * chunkSize tiles, row-major */
+void Level::read_chunk(SDL_Point _chunk, Tile* _tiles) const {
+    const size_t _chunkBytes = static_cast<size_t>(header->chunkSize) * header->chunkSize;
+    if (pread(file, _tiles, _chunkBytes, static_cast<off_t>(get_chunk_offset(_chunk))) != static_cast<ssize_t>(_chunkBytes)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "pread() failed for chunk (%d, %d): %s", _chunk.x, _chunk.y, std::strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < _chunkBytes; ++i) {
+        if (static_cast<std::uint8_t>(_tiles[i]) > static_cast<std::uint8_t>(Tile::fruit)) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Chunk (%d, %d) has an unknown tile at %zu", _chunk.x, _chunk.y, i);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+/* Asks the OS to start reading a chunk in the background, so a later
+ * read_chunk finds it in the page cache instead of waiting on the disk */
+void Level::prefetch_chunk(SDL_Point _chunk) const {
+    const size_t _chunkBytes = static_cast<size_t>(header->chunkSize) * header->chunkSize;
+#if defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(file, static_cast<off_t>(get_chunk_offset(_chunk)), static_cast<off_t>(_chunkBytes), POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+    struct radvisory _advisory = {static_cast<off_t>(get_chunk_offset(_chunk)), static_cast<int>(_chunkBytes)};
+    fcntl(file, F_RDADVISE, &_advisory);
+#endif
+}
@@ -1,7 +1,83 @@
+#include "level.hpp"
+#include "profiler.hpp"
 #include "scene.hpp"
+#include "simulation.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
 
-int main() {
-    Scene scene = Scene();
+int main(int argc, char* argv[]) {
+    bool _headless = false;
+    int _numGames = 1000;
+    long _maxTicks = 120L * 60;
+    const char* _scriptPath = nullptr;
+    const char* _statsPath = nullptr;
+    const char* _tracePath = nullptr;
+    bool _seeded = false;
+    std::uint64_t _seed = 0;
+    const char* _levelPath = nullptr;
+    EnemyMode _enemyMode = EnemyMode::wander;
+    int _maxBombs = 8;
+    int _numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            _headless = true;
+        } else if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            _numGames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            _maxTicks = std::atol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            _scriptPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc) {
+            _statsPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            _tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            _seed = std::strtoull(argv[++i], nullptr, 0);
+            _seeded = true;
+        } else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            _levelPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--chase") == 0) {
+            _enemyMode = EnemyMode::chase;
+        } else if (std::strcmp(argv[i], "--max-bombs") == 0 && i + 1 < argc) {
+            _maxBombs = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            _numThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--convert") == 0 && i + 2 < argc) {
+            Level::convert(argv[i + 1], argv[i + 2]);
+            return EXIT_SUCCESS;
+        } else {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unknown argument: %s", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Logged so an unseeded run can be reproduced with --seed */
+    if (!_seeded) {
+        std::random_device _device;
+        _seed = (static_cast<std::uint64_t>(_device()) << 32) | _device();
+    }
+    SDL_Log("Seed: %llu", static_cast<unsigned long long>(_seed));
+
+    const Level level = _levelPath != nullptr ? Level(_levelPath) : Level();
+
+    if (_headless) {
+        Simulation simulation = Simulation(_numGames, _maxTicks, 120.0, _scriptPath, level, _enemyMode, _maxBombs, _numThreads, _seed);
+        simulation.run();
+        if (_tracePath != nullptr) {
+            PROFILE_EXPORT(_tracePath);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    Scene scene = Scene(_statsPath, _tracePath != nullptr ? _tracePath : "trace.json", level, _enemyMode, _maxBombs, _numThreads, _seed);
     scene.run();
+    if (_tracePath != nullptr) {
+        PROFILE_EXPORT(_tracePath);
+    }
     return EXIT_SUCCESS;
 }
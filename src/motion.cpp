@@ -0,0 +1,139 @@
+#include "motion.hpp"
+#include <utility>
+
+MotionTable::MotionTable(
+    int _numRows,
+    int _numCols,
+    int _tileSize,
+    SDL_Point _gridOffset
+) :
+    numRows(_numRows),
+    numCols(_numCols),
+    tileSize(_tileSize),
+    gridOffset(_gridOffset),
+    xs(),
+    ys(),
+    offsets(),
+    speeds(),
+    directions(),
+    rectXs(),
+    rectYs(),
+    prevXs(),
+    prevYs(),
+    events()
+{}
+
+void MotionTable::reserve(size_t _capacity) {
+    xs.reserve(_capacity);
+    ys.reserve(_capacity);
+    offsets.reserve(_capacity);
+    speeds.reserve(_capacity);
+    directions.reserve(_capacity);
+    rectXs.reserve(_capacity);
+    rectYs.reserve(_capacity);
+    prevXs.reserve(_capacity);
+    prevYs.reserve(_capacity);
+    events.reserve(_capacity);
+}
+
+void MotionTable::add(SDL_Point _position, double _offset, double _speed, Direction _direction) {
+    xs.push_back(_position.x);
+    ys.push_back(_position.y);
+    offsets.push_back(_offset);
+    speeds.push_back(_speed);
+    directions.push_back(_direction);
+    rectXs.push_back(0);
+    rectYs.push_back(0);
+    prevXs.push_back(0);
+    prevYs.push_back(0);
+    events.push_back(0);
+    update_rect(size() - 1);
+    prevXs.back() = rectXs.back();
+    prevYs.back() = rectYs.back();
+}
+
+void MotionTable::swap(size_t _first, size_t _second) {
+    std::swap(xs[_first], xs[_second]);
+    std::swap(ys[_first], ys[_second]);
+    std::swap(offsets[_first], offsets[_second]);
+    std::swap(speeds[_first], speeds[_second]);
+    std::swap(directions[_first], directions[_second]);
+    std::swap(rectXs[_first], rectXs[_second]);
+    std::swap(rectYs[_first], rectYs[_second]);
+    std::swap(prevXs[_first], prevXs[_second]);
+    std::swap(prevYs[_first], prevYs[_second]);
+    std::swap(events[_first], events[_second]);
+}
+
+void MotionTable::pop_back() {
+    xs.pop_back();
+    ys.pop_back();
+    offsets.pop_back();
+    speeds.pop_back();
+    directions.pop_back();
+    rectXs.pop_back();
+    rectYs.pop_back();
+    prevXs.pop_back();
+    prevYs.pop_back();
+    events.pop_back();
+}
+
+void MotionTable::clear() {
+    xs.clear();
+    ys.clear();
+    offsets.clear();
+    speeds.clear();
+    directions.clear();
+    rectXs.clear();
+    rectYs.clear();
+    prevXs.clear();
+    prevYs.clear();
+    events.clear();
+}
+
+void MotionTable::set_position(size_t _index, SDL_Point _position) {
+    xs[_index] = _position.x;
+    ys[_index] = _position.y;
+    update_rect(_index);
+}
+
+void MotionTable::set_offset(size_t _index, double _offset) {
+    offsets[_index] = _offset;
+    update_rect(_index);
+}
+
+void MotionTable::set_direction(size_t _index, Direction _direction) {
+    directions[_index] = _direction;
+    update_rect(_index);
+}
+
+void MotionTable::set_speed(size_t _index, double _speed) {
+    speeds[_index] = _speed;
+}
+
+/* Not clamped: one stopped at the board's edge steps off it here and walks
+ * back on with the next integrate() */
+void MotionTable::reverse(size_t _index, Direction _direction) {
+    xs[_index] += stepX[static_cast<int>(directions[_index])];
+    ys[_index] += stepY[static_cast<int>(directions[_index])];
+    offsets[_index] = tileSize - offsets[_index];
+    directions[_index] = _direction;
+}
+
+void MotionTable::translate(SDL_Point _delta) {
+    for (size_t i = 0; i < size(); ++i) {
+        xs[i] += _delta.x;
+        ys[i] += _delta.y;
+        rectXs[i] += _delta.x * tileSize;
+        rectYs[i] += _delta.y * tileSize;
+        prevXs[i] += _delta.x * tileSize;
+        prevYs[i] += _delta.y * tileSize;
+    }
+}
+
+/* An entity is drawn at its tile plus the distance covered toward the next */
+void MotionTable::update_rect(size_t _index) {
+    const int _offset = static_cast<int>(offsets[_index]);
+    rectXs[_index] = gridOffset.x + tileSize * xs[_index] + stepX[static_cast<int>(directions[_index])] * _offset;
+    rectYs[_index] = gridOffset.y + tileSize * ys[_index] + stepY[static_cast<int>(directions[_index])] * _offset;
+}
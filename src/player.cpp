@@ -18,54 +18,28 @@ Player::Player(
 ) :
     window(_window),
     renderer(_renderer),
-    numRows(_numRows),
-    numCols(_numCols),
     tileSize(_tileSize),
-    gridOffset(_gridOffset),
-    position(_position),
-    speed(_speed),
-    offset(tileSize - 0.01),
-    direction(_direction),
+    motion(_numRows, _numCols, _tileSize, _gridOffset),
     keyBuffer(),
-    turnBuffer(),
-    prevTime(),
-    prevTimeValid(false)
-{}
+    turnBuffer()
+{
+    motion.add(_position, tileSize - 0.01, _speed, _direction);
+}
 
 SDL_Point Player::get_position() const {
-    return position;
+    return motion.get_position(0);
 }
 
 SDL_Point Player::get_next_position() const {
-    SDL_Point nextPosition(position);
-
-    switch (direction) {
-        case Direction::up:
-            nextPosition.y = std::max(0, nextPosition.y - 1);
-            break;
-        case Direction::down:
-            nextPosition.y = std::min(numRows - 1, nextPosition.y + 1);
-            break;
-        case Direction::left:
-            nextPosition.x = std::max(0, nextPosition.x - 1);
-            break;
-        case Direction::right:
-            nextPosition.x = std::min(numCols - 1, nextPosition.x + 1);
-            break;
-        default:
-            break;
-    }
+    return motion.get_next_position(0);
+}
 
-    return nextPosition;
+Direction Player::get_direction() const {
+    return motion.get_direction(0);
 }
 
 bool Player::check_collision() {
-    SDL_Rect playerRect = {
-        gridOffset.x + tileSize * position.x,
-        gridOffset.y + tileSize * position.y,
-        tileSize,
-        tileSize
-    };
+    SDL_Rect playerRect = motion.get_rect(0);
 
     /* TODO: Check collision with enemies */
 
@@ -133,199 +107,66 @@ void Player::set_direction(const Keyboard _keyboard, SDL_Keycode _key) {
         }
     }
 
-    while (!turnBuffer.empty() && turnBuffer.front() == direction) {
+    while (!turnBuffer.empty() && turnBuffer.front() == get_direction()) {
         turnBuffer.pop();
     }
 }
 
 void Player::collided_with_wall(const bool turned, const SDL_Point prevPos) {
-    position = prevPos;
-    offset = tileSize - 0.0001;
+    motion.set_position(0, prevPos);
+    motion.set_offset(0, tileSize - 0.0001);
 }
 
-int Player::move() {
-    auto _currTime = highest_resolution_steady_clock::now();
-    if (!prevTimeValid) {
-        prevTime = _currTime;
-        prevTimeValid = true;
-        return -1;
-    }
-
-    /* Check if any time has passed */
-    auto _interval = std::chrono::duration_cast<std::chrono::nanoseconds>(_currTime - prevTime).count();
-    if (_interval <= 0) {
-        return -1;
-    }
-
+/* Reversing turns around on the spot; any other turn waits for the player
+ * to reach a tile, or is taken at once when stopped at the board's edge */
+int Player::move(double _dt) {
     /* Check if we are reversing directions */
     if (!turnBuffer.empty()) {
-        switch (direction) {
-            case Direction::up:
-                if (turnBuffer.front() == Direction::down) {
-                    --position.y;
-                    offset = tileSize - offset;
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-                break;
-            case Direction::down:
-                if (turnBuffer.front() == Direction::up) {
-                    ++position.y;
-                    offset = tileSize - offset;
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-                break;
-            case Direction::left:
-                if (turnBuffer.front() == Direction::right) {
-                    --position.x;
-                    offset = tileSize - offset;
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-                break;
-            case Direction::right:
-                if (turnBuffer.front() == Direction::left) {
-                    ++position.x;
-                    offset = tileSize - offset;
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-                break;
-            default:
-                break;
+        const Direction _direction = get_direction();
+        const Direction _turn = turnBuffer.front();
+        if ((_direction == Direction::up && _turn == Direction::down)
+            || (_direction == Direction::down && _turn == Direction::up)
+            || (_direction == Direction::left && _turn == Direction::right)
+            || (_direction == Direction::right && _turn == Direction::left)) {
+            motion.reverse(0, _turn);
+            turnBuffer.pop();
         }
     }
 
     /* Move the player */
-    offset += speed / (1e9 / _interval);
-    prevTime = _currTime;
-
-    switch (direction) {
-        case Direction::up:
-            position.y -= static_cast<int>(offset) / tileSize;
-            if (position.y <= 0) {
-                position.y = 0;
-                offset = 0;
-                if (!turnBuffer.empty()) {
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-            }
-            break;
-        case Direction::down:
-            position.y += static_cast<int>(offset) / tileSize;
-            if (position.y >= numRows - 1) {
-                position.y = numRows - 1;
-                offset = 0;
-                if (!turnBuffer.empty()) {
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-            }
-            break;
-        case Direction::left:
-            position.x -= static_cast<int>(offset) / tileSize;
-            if (position.x <= 0) {
-                position.x = 0;
-                offset = 0;
-                if (!turnBuffer.empty()) {
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-            }
-            break;
-        case Direction::right:
-            position.x += static_cast<int>(offset) / tileSize;
-            if (position.x >= numCols - 1) {
-                position.x = numCols - 1;
-                offset = 0;
-                if (!turnBuffer.empty()) {
-                    direction = turnBuffer.front();
-                    turnBuffer.pop();
-                }
-            }
-            break;
-        default:
-            break;
-    }
+    motion.integrate(0, 1, _dt, Arrival::carry);
 
     int turned = 0;
-    if (offset >= tileSize) {
-        if (!turnBuffer.empty()) {
-            Direction newDirection = turnBuffer.front();
-            turned = direction != newDirection;
-            direction = newDirection;
-            turnBuffer.pop();
+    if (!turnBuffer.empty() && motion.get_events(0) != 0) {
+        const Direction newDirection = turnBuffer.front();
+        if (motion.get_events(0) & MotionTable::reachedTile) {
+            turned = get_direction() != newDirection;
         }
-
-        offset = fmod(offset, tileSize);
+        motion.set_direction(0, newDirection);
+        turnBuffer.pop();
     }
     return turned;
 }
 
-void Player::draw() {
-    if (SDL_SetRenderDrawColor(renderer, 255, 255, 0, SDL_ALPHA_OPAQUE) < 0) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
-        exit(EXIT_FAILURE);
-    }
-
-    SDL_Rect playerRect = get_rect();
-
-    SDL_RenderFillRect(renderer, &playerRect);
-
-    if (SDL_SetRenderDrawColor(renderer, 255, 215, 0, SDL_ALPHA_OPAQUE) < 0) {
-        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetRenderDrawColor() failed: %s", SDL_GetError());
-        exit(EXIT_FAILURE);
-    }
-
-    for (auto& bomb : bombs) {
-        SDL_Rect bombRect = bomb.get_rect();
-        SDL_RenderFillRect(renderer, &bombRect);
-    }
-}
-
 void Player::reset(SDL_Point _position, double _speed, Direction _direction) {
-    position = _position;
-    speed = _speed;
-    offset = tileSize - 0.01;
-    direction = Direction::right;
+    motion.clear();
+    motion.add(_position, tileSize - 0.01, _speed, Direction::right);
     keyBuffer.clear();
     while (!turnBuffer.empty()) {
         turnBuffer.pop();
     }
-    prevTimeValid = false;
-    bombs.clear();
 }
 
 SDL_Rect Player::get_rect() const {
-    SDL_Rect playerRect = {
-        gridOffset.x + tileSize * position.x,
-        gridOffset.y + tileSize * position.y,
-        tileSize,
-        tileSize
-    };
+    return motion.get_rect(0);
+}
 
-    switch (direction) {
-        case Direction::up:
-            playerRect.y -= static_cast<int>(offset);
-            break;
-            
-        case Direction::down:
-            playerRect.y += static_cast<int>(offset);
-            break;
-            
-        case Direction::left:
-            playerRect.x -= static_cast<int>(offset);
-            break;
-            
-        case Direction::right:
-            playerRect.x += static_cast<int>(offset);
-            break;
-            
-        default:
-            break;
-    }
+SDL_Rect Player::get_prev_rect() const {
+    return motion.get_prev_rect(0);
+}
 
-    return playerRect;
+/* Moves by whole tiles along with the board. The previous rect moves too,
+ * so interpolation does not streak across the jump. */
+void Player::translate(SDL_Point _delta) {
+    motion.translate(_delta);
 }
@@ -0,0 +1,116 @@
+#include "profiler.hpp"
+
+#ifdef PROFILER_ENABLED
+
+#include "highest_resolution_steady_clock.hpp"
+#include <cstdio>
+#include <SDL.h>
+
+std::mutex Profiler::registryMutex;
+std::vector<std::shared_ptr<Profiler::ThreadBuffer>> Profiler::registry;
+
+Profiler::Zone::Zone(const char* _name) :
+    name(_name),
+    start(now())
+{}
+
+Profiler::Zone::~Zone() {
+    push({name, start, now() - start, 0, false});
+}
+
+void Profiler::counter(const char* _name, std::int64_t _value) {
+    push({_name, now(), 0, _value, true});
+}
+
+std::int64_t Profiler::now() {
+    static const auto _epoch = highest_resolution_steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(highest_resolution_steady_clock::now() - _epoch).count();
+}
+
+Profiler::ThreadBuffer& Profiler::thread_buffer() {
+    /* Buffers stay registered after their thread exits so its events can still be exported */
+    thread_local std::shared_ptr<ThreadBuffer> _buffer = [] {
+        auto _newBuffer = std::make_shared<ThreadBuffer>();
+        _newBuffer->head.store(0, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> _lock(registryMutex);
+        _newBuffer->threadId = static_cast<int>(registry.size()) + 1;
+        registry.push_back(_newBuffer);
+        return _newBuffer;
+    }();
+
+    return *_buffer;
+}
+
+void Profiler::push(const Event& _event) {
+    ThreadBuffer& _buffer = thread_buffer();
+    const std::uint64_t _head = _buffer.head.load(std::memory_order_relaxed);
+    Slot& _slot = _buffer.slots[_head % bufferCapacity];
+    /* Released field by field, so a reader that sees any new field also sees the odd sequence */
+    _slot.sequence.store(2 * _head + 1, std::memory_order_relaxed);
+    _slot.name.store(_event.name, std::memory_order_release);
+    _slot.start.store(_event.start, std::memory_order_release);
+    _slot.duration.store(_event.duration, std::memory_order_release);
+    _slot.value.store(_event.value, std::memory_order_release);
+    _slot.isCounter.store(_event.isCounter, std::memory_order_release);
+    _slot.sequence.store(2 * _head + 2, std::memory_order_release);
+    _buffer.head.store(_head + 1, std::memory_order_release);
+}
+
+void Profiler::export_trace(const char* _path) {
+    std::FILE* _file = std::fopen(_path, "w");
+    if (_file == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to write trace: %s", _path);
+        return;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+    {
+        std::lock_guard<std::mutex> _lock(registryMutex);
+        _buffers = registry;
+    }
+
+    std::fprintf(_file, "{\"traceEvents\":[\n");
+    bool _first = true;
+    std::vector<Event> _events;
+    for (const auto& _buffer : _buffers) {
+        /* Copy the newest events, dropping any the owning thread was writing
+         * or had already overwritten when its slot was read */
+        const std::uint64_t _head = _buffer->head.load(std::memory_order_acquire);
+        const std::uint64_t _tail = _head > bufferCapacity ? _head - bufferCapacity : 0;
+        _events.clear();
+        for (std::uint64_t i = _tail; i < _head; ++i) {
+            const Slot& _slot = _buffer->slots[i % bufferCapacity];
+            const std::uint64_t _sequence = _slot.sequence.load(std::memory_order_acquire);
+            const Event _event = {
+                _slot.name.load(std::memory_order_acquire),
+                _slot.start.load(std::memory_order_acquire),
+                _slot.duration.load(std::memory_order_acquire),
+                _slot.value.load(std::memory_order_acquire),
+                _slot.isCounter.load(std::memory_order_acquire)
+            };
+            if (_sequence == 2 * i + 2 && _slot.sequence.load(std::memory_order_relaxed) == _sequence) {
+                _events.push_back(_event);
+            }
+        }
+
+        std::fprintf(_file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+            _first ? "" : ",\n", _buffer->threadId, _buffer->threadId);
+        _first = false;
+
+        for (auto it = _events.begin(); it != _events.end(); ++it) {
+            if (it->isCounter) {
+                std::fprintf(_file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"value\":%lld}}",
+                    it->name, it->start / 1e3, _buffer->threadId, static_cast<long long>(it->value));
+            } else {
+                std::fprintf(_file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                    it->name, it->start / 1e3, it->duration / 1e3, _buffer->threadId);
+            }
+        }
+    }
+    std::fprintf(_file, "\n]}\n");
+    std::fclose(_file);
+
+    SDL_Log("Wrote trace: %s", _path);
+}
+
+#endif
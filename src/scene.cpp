@@ -1,16 +1,38 @@
 #include "scene.hpp"
+#include "profiler.hpp"
+#include <algorithm>
 #include <cstdlib>
+#include <thread>
 
-Scene::Scene() :
+/* Searched in order; the embedded font is used when none of them exist */
+static const std::vector<std::string> fontCandidates{
+    "/System/Library/Fonts/Monaco.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+    "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+    "/usr/share/fonts/dejavu-sans-mono-fonts/DejaVuSansMono.ttf",
+    "C:\\Windows\\Fonts\\consola.ttf"
+};
+
+Scene::Scene(const char* _statsPath, const char* _tracePath, const Level& _level, EnemyMode _enemyMode, int _maxBombs, int _numThreads, std::uint64_t _seed) :
     windowName("Pac-Man with Bombs!"),
-    vsyncOn(true),
+    statsPath(_statsPath),
+    tracePath(_tracePath),
+    fontPath(Assets::find_font(fontCandidates)),
+    /* Starts reading the font before SDL_Init so the two overlap */
+    assets({fontPath}),
     window(init_window()),
     renderer(init_renderer()),
-    prevTime(),
-    prevTimeValid(false),
-    maxRefreshRate(60.0),
-    fpsCounter(window, renderer),
-    game(window, renderer)
+    framePacer(renderer, FramePacer::Mode::adaptive, 60.0),
+    tickRate(120.0),
+    maxFrameTime(0.25),
+    textRenderer(renderer, assets.get_font(fontPath, 14)),
+    fpsCounter(window, renderer, &textRenderer),
+    threadPool(static_cast<unsigned int>(_numThreads)),
+    game(window, renderer, &textRenderer, _level, _enemyMode, _maxBombs, threadPool, _seed),
+    running(false),
+    inputMutex(),
+    inputQueue(),
+    snapshots()
 {}
 
 SDL_Window* Scene::init_window() {
@@ -29,11 +51,8 @@ SDL_Window* Scene::init_window() {
 }
 
 SDL_Renderer* Scene::init_renderer() {
-    Uint32 _rendererFlags = SDL_RENDERER_ACCELERATED;
-    if (vsyncOn) {
-        _rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
-    }
-    SDL_Renderer* _renderer = SDL_CreateRenderer(window, -1, _rendererFlags);
+    /* Vsync is switched on and off by the frame pacer */
+    SDL_Renderer* _renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
     if (_renderer == nullptr) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_CreateRenderer() failed: %s", SDL_GetError());
         exit(EXIT_FAILURE);
@@ -43,14 +62,130 @@ SDL_Renderer* Scene::init_renderer() {
 }
 
 void Scene::run() {
-    while (game.gameOn()) {
+    game.snapshot(snapshots.write_buffer());
+    snapshots.write_buffer().tickTime = highest_resolution_steady_clock::now();
+    snapshots.publish();
+
+    running.store(true, std::memory_order_release);
+    std::thread _simThread(&Scene::simulate, this);
+
+    const double _tickInterval = 1.0 / tickRate;
+    while (running.load(std::memory_order_acquire)) {
+        PROFILE_ZONE("Scene::run");
+        const auto _pollTime = highest_resolution_steady_clock::now();
+        poll();
+
+        const auto _drawTime = highest_resolution_steady_clock::now();
+        snapshots.update();
+        const RenderSnapshot& _snapshot = snapshots.read_buffer();
+
+        /* Draw one tick behind the simulation, blending toward its newest state */
+        const double _alpha = std::clamp(std::chrono::duration<double>(_drawTime - _snapshot.tickTime).count() / _tickInterval, 0.0, 1.0);
         clear_frame();
-        game.poll();
-        game.step();
-        game.draw();
+        game.draw(_snapshot, _alpha);
         fpsCounter.draw();
+
+        const auto _presentTime = highest_resolution_steady_clock::now();
         display_frame();
-        delay_frame();
+
+        fpsCounter.record_phase(FPSCounter::Phase::poll, _drawTime - _pollTime);
+        fpsCounter.record_phase(FPSCounter::Phase::draw, _presentTime - _drawTime);
+        fpsCounter.record_phase(FPSCounter::Phase::present, highest_resolution_steady_clock::now() - _presentTime);
+        framePacer.wait();
+    }
+
+    _simThread.join();
+    framePacer.log_error();
+    /* Only chunked levels read chunks */
+    if (game.get_chunk_misses() != 0) {
+        SDL_Log("Read %lu level chunks", game.get_chunk_misses());
+    }
+}
+
+/* Runs on its own thread: steps the game at the fixed tick and publishes a
+ * snapshot after each batch of ticks, independent of how long presenting takes */
+void Scene::simulate() {
+    const double _tickInterval = 1.0 / tickRate;
+    double _accumulator = 0.0;
+    std::vector<SDL_Event> _events;
+    auto _prevTime = highest_resolution_steady_clock::now();
+    while (running.load(std::memory_order_acquire)) {
+        {
+            std::lock_guard<std::mutex> _lock(inputMutex);
+            _events.swap(inputQueue);
+        }
+        for (const auto& _event : _events) {
+            game.handle_event(_event);
+        }
+        _events.clear();
+
+        const auto _currTime = highest_resolution_steady_clock::now();
+        const double _frameTime = std::chrono::duration<double>(_currTime - _prevTime).count();
+        _prevTime = _currTime;
+
+        /* Clamp long stalls so the simulation cannot spiral trying to catch up */
+        _accumulator += std::min(_frameTime, maxFrameTime);
+
+        bool _stepped = false;
+        while (_accumulator >= _tickInterval && game.gameOn()) {
+            game.step(_tickInterval);
+            _accumulator -= _tickInterval;
+            _stepped = true;
+        }
+
+        if (!game.gameOn()) {
+            running.store(false, std::memory_order_release);
+            return;
+        }
+
+        if (_stepped) {
+            RenderSnapshot& _snapshot = snapshots.write_buffer();
+            game.snapshot(_snapshot);
+            _snapshot.tickTime = _currTime - std::chrono::duration_cast<highest_resolution_steady_clock::duration>(std::chrono::duration<double>(_accumulator));
+            snapshots.publish();
+            fpsCounter.record_phase(FPSCounter::Phase::step, highest_resolution_steady_clock::now() - _currTime);
+        }
+
+        std::this_thread::sleep_until(_currTime + std::chrono::duration_cast<highest_resolution_steady_clock::duration>(std::chrono::duration<double>(_tickInterval - _accumulator)));
+    }
+}
+
+void Scene::poll() {
+    PROFILE_ZONE("Scene::poll");
+    for (SDL_Event _event; SDL_PollEvent(&_event) != 0;) {
+        if (_event.type == SDL_RENDER_TARGETS_RESET || _event.type == SDL_RENDER_DEVICE_RESET) {
+            game.invalidate_render_cache();
+            continue;
+        }
+
+        /* F1-F4 select the frame pacing mode, F5 toggles the frame time overlay, F6 exports a trace */
+        if (_event.type == SDL_KEYDOWN && _event.key.repeat == 0) {
+            switch (_event.key.keysym.sym) {
+                case SDLK_F1:
+                    framePacer.set_mode(FramePacer::Mode::vsync);
+                    continue;
+                case SDLK_F2:
+                    framePacer.set_mode(FramePacer::Mode::capped);
+                    continue;
+                case SDLK_F3:
+                    framePacer.set_mode(FramePacer::Mode::uncapped);
+                    continue;
+                case SDLK_F4:
+                    framePacer.set_mode(FramePacer::Mode::adaptive);
+                    continue;
+                case SDLK_F5:
+                    fpsCounter.toggle_overlay();
+                    continue;
+                case SDLK_F6:
+                    PROFILE_EXPORT(tracePath);
+                    continue;
+                default:
+                    break;
+            }
+        }
+
+        std::lock_guard<std::mutex> _lock(inputMutex);
+        inputQueue.push_back(_event);
     }
 }
 
@@ -70,27 +205,13 @@ void Scene::display_frame() {
     SDL_RenderPresent(renderer);
 }
 
-void Scene::delay_frame() {
-    if (maxRefreshRate <= 0.0) {
-        return;
-    }
-
-    if (!prevTimeValid) {
-        prevTime = highest_resolution_steady_clock::now();
-        prevTimeValid = true;
-        return;
-    }
-
-    const auto _interval = std::chrono::duration_cast<std::chrono::nanoseconds>(highest_resolution_steady_clock::now() - prevTime).count();
-    if (_interval < 1e9 / maxRefreshRate) {
-        SDL_Delay((1e9 / maxRefreshRate - _interval) / 1e6);
-    }
-
-    prevTime = highest_resolution_steady_clock::now();
-}
-
 Scene::~Scene() {
-    fpsCounter.shutdown();
+    if (statsPath != nullptr) {
+        fpsCounter.dump(statsPath);
+    }
+    game.shutdown();
+    textRenderer.shutdown();
+    assets.shutdown();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_Quit();
@@ -0,0 +1,153 @@
+#include "simulation.hpp"
+#include "game.hpp"
+#include "highest_resolution_steady_clock.hpp"
+#include "random.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+Simulation::Simulation(
+    int _numGames,
+    long _maxTicks,
+    double _tickRate,
+    const char* _scriptPath,
+    const Level& _level,
+    EnemyMode _enemyMode,
+    int _maxBombs,
+    int _numThreads,
+    std::uint64_t _seed
+) :
+    numGames(_numGames),
+    maxTicks(_maxTicks),
+    tickRate(_tickRate),
+    level(_level),
+    enemyMode(_enemyMode),
+    maxBombs(_maxBombs),
+    threadPool(static_cast<unsigned int>(_numThreads)),
+    seed(_seed),
+    script(init_script(_scriptPath)),
+    scriptLength(script.empty() ? 1 : script.back().tick + 1)
+{}
+
+/* Scripts are lines of "<tick> <key> <down|up>", where key is one of
+ * w, a, s, d or space. The script repeats once its last tick is reached. */
+std::vector<Simulation::ScriptedEvent> Simulation::init_script(const char* _scriptPath) const {
+    std::stringstream _source;
+    if (_scriptPath == nullptr) {
+        _source <<
+            "0 d down\n"
+            "40 space down\n"   "41 space up\n"
+            "60 d up\n"         "60 s down\n"
+            "100 space down\n"  "101 space up\n"
+            "120 s up\n"        "120 a down\n"
+            "160 space down\n"  "161 space up\n"
+            "180 a up\n"        "180 w down\n"
+            "220 space down\n"  "221 space up\n"
+            "240 w up\n";
+    } else {
+        std::ifstream _file(_scriptPath);
+        if (!_file) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to open input script: %s", _scriptPath);
+            exit(EXIT_FAILURE);
+        }
+        _source << _file.rdbuf();
+    }
+
+    std::vector<ScriptedEvent> _script;
+    for (std::string _line; std::getline(_source, _line);) {
+        if (_line.empty() || _line.front() == '#') {
+            continue;
+        }
+
+        std::istringstream _fields(_line);
+        long _tick;
+        std::string _key, _action;
+        if (!(_fields >> _tick >> _key >> _action) || _tick < 0 || (_action != "down" && _action != "up")) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Invalid input script line: %s", _line.c_str());
+            exit(EXIT_FAILURE);
+        }
+
+        SDL_Keycode _keycode;
+        if (_key == "w") {
+            _keycode = SDLK_w;
+        } else if (_key == "a") {
+            _keycode = SDLK_a;
+        } else if (_key == "s") {
+            _keycode = SDLK_s;
+        } else if (_key == "d") {
+            _keycode = SDLK_d;
+        } else if (_key == "space") {
+            _keycode = SDLK_SPACE;
+        } else {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Invalid input script key: %s", _key.c_str());
+            exit(EXIT_FAILURE);
+        }
+
+        _script.push_back({_tick, _keycode, _action == "down"});
+    }
+
+    std::stable_sort(_script.begin(), _script.end(), [](const ScriptedEvent& _a, const ScriptedEvent& _b) {
+        return _a.tick < _b.tick;
+    });
+
+    return _script;
+}
+
+SDL_Event Simulation::make_event(const ScriptedEvent& _scriptedEvent) const {
+    SDL_Event _event;
+    std::memset(&_event, 0, sizeof(_event));
+    _event.type = _scriptedEvent.pressed ? SDL_KEYDOWN : SDL_KEYUP;
+    _event.key.state = _scriptedEvent.pressed ? SDL_PRESSED : SDL_RELEASED;
+    _event.key.keysym.sym = _scriptedEvent.key;
+
+    return _event;
+}
+
+void Simulation::run() {
+    const double _tickInterval = 1.0 / tickRate;
+    long _totalTicks = 0;
+    int _roundsOver = 0;
+    unsigned long _chunkMisses = 0;
+
+    const auto _startTime = highest_resolution_steady_clock::now();
+    for (int _gameIndex = 0; _gameIndex < numGames; ++_gameIndex) {
+        /* Each game gets its own seed, so any one of them can be replayed alone */
+        Game _game(nullptr, nullptr, nullptr, level, enemyMode, maxBombs, threadPool, Random(seed, _gameIndex).next());
+        size_t _next = 0;
+        for (long _tick = 0; _tick < maxTicks && _game.gameOn() && !_game.roundOver(); ++_tick) {
+            const long _scriptTick = _tick % scriptLength;
+            if (_scriptTick == 0) {
+                _next = 0;
+            }
+
+            while (_next < script.size() && script[_next].tick == _scriptTick) {
+                _game.handle_event(make_event(script[_next]));
+                ++_next;
+            }
+
+            _game.step(_tickInterval);
+            ++_totalTicks;
+        }
+
+        if (_game.roundOver()) {
+            ++_roundsOver;
+        }
+        _chunkMisses += _game.get_chunk_misses();
+    }
+    const double _elapsed = std::chrono::duration<double>(highest_resolution_steady_clock::now() - _startTime).count();
+
+    SDL_Log("Simulated %d games (%d finished, %ld ticks) in %.3f s: %.1f games/s, %.0f ticks/s",
+        numGames,
+        _roundsOver,
+        _totalTicks,
+        _elapsed,
+        numGames / _elapsed,
+        _totalTicks / _elapsed
+    );
+    if (level.get_chunk_size() != 0) {
+        SDL_Log("Read %lu level chunks", _chunkMisses);
+    }
+}
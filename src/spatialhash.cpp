@@ -0,0 +1,139 @@
+#include "spatialhash.hpp"
+#include <algorithm>
+#include <bit>
+#include "profiler.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* An entity overlaps _rect when its corner lies strictly inside _rect grown
+ * by one tile up and left, the same test as SDL_HasIntersection */
+static SDL_Rect calc_bounds(const SDL_Rect& _rect, int _tileSize) {
+    return {_rect.x - _tileSize, _rect.y - _tileSize, _rect.w + _tileSize, _rect.h + _tileSize};
+}
+
+/* Tests the corners from _first to _last, four at a time where SSE2 is
+ * available, and reads the hits back from the compare mask. A hit appends
+ * its id, or its index when there are no ids. */
+static void scan_run(
+    const int* _xs,
+    const int* _ys,
+    const std::uint32_t* _ids,
+    size_t _first,
+    size_t _last,
+    const SDL_Rect& _bounds,
+    std::vector<std::uint32_t>& _hits
+) {
+    const int _right = _bounds.x + _bounds.w;
+    const int _bottom = _bounds.y + _bounds.h;
+    size_t i = _first;
+#if defined(__SSE2__)
+    const __m128i _lefts = _mm_set1_epi32(_bounds.x);
+    const __m128i _rights = _mm_set1_epi32(_right);
+    const __m128i _tops = _mm_set1_epi32(_bounds.y);
+    const __m128i _bottoms = _mm_set1_epi32(_bottom);
+    for (; i + 4 <= _last; i += 4) {
+        const __m128i _x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_xs + i));
+        const __m128i _y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_ys + i));
+        const __m128i _insideX = _mm_and_si128(_mm_cmpgt_epi32(_x, _lefts), _mm_cmplt_epi32(_x, _rights));
+        const __m128i _insideY = _mm_and_si128(_mm_cmpgt_epi32(_y, _tops), _mm_cmplt_epi32(_y, _bottoms));
+        auto _mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(_insideX, _insideY))));
+        for (; _mask != 0; _mask &= _mask - 1) {
+            const size_t _hit = i + std::countr_zero(_mask);
+            _hits.push_back(_ids != nullptr ? _ids[_hit] : static_cast<std::uint32_t>(_hit));
+        }
+    }
+#endif
+    for (; i < _last; ++i) {
+        if (_xs[i] > _bounds.x && _xs[i] < _right && _ys[i] > _bounds.y && _ys[i] < _bottom) {
+            _hits.push_back(_ids != nullptr ? _ids[i] : static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+/* Cells are this many tiles across, which keeps the cell table small on a
+ * large board while a blast still only reaches a handful of cells */
+static constexpr int cellTiles = 4;
+
+SpatialHash::SpatialHash(int _rows, int _cols, int _tileSize, SDL_Point _gridOffset) :
+    tileSize(_tileSize),
+    gridOffset(_gridOffset),
+    cellSize(_tileSize * cellTiles),
+    numCellRows((_rows + cellTiles - 1) / cellTiles),
+    numCellCols((_cols + cellTiles - 1) / cellTiles),
+    cellStarts(static_cast<size_t>(numCellRows * numCellCols) + 1, 0),
+    cellFill(static_cast<size_t>(numCellRows * numCellCols), 0),
+    entityCells(),
+    xs(),
+    ys(),
+    ids()
+{}
+
+/* Entities past the board's edges land in the edge cells; queries clamp the
+ * same way, so they are still found */
+int SpatialHash::calc_cell_column(int _x) const {
+    return std::clamp((_x - gridOffset.x) / cellSize, 0, numCellCols - 1);
+}
+
+int SpatialHash::calc_cell_row(int _y) const {
+    return std::clamp((_y - gridOffset.y) / cellSize, 0, numCellRows - 1);
+}
+
+void SpatialHash::build(std::span<const int> _xs, std::span<const int> _ys) {
+    PROFILE_ZONE("SpatialHash::build");
+    const size_t _count = _xs.size();
+    entityCells.resize(_count);
+    xs.resize(_count);
+    ys.resize(_count);
+    ids.resize(_count);
+
+    /* Count the entities in each cell, then turn the counts into run starts */
+    std::fill(cellStarts.begin(), cellStarts.end(), 0);
+    for (size_t i = 0; i < _count; ++i) {
+        entityCells[i] = static_cast<std::uint32_t>(calc_cell_row(_ys[i]) * numCellCols + calc_cell_column(_xs[i]));
+        ++cellStarts[entityCells[i] + 1];
+    }
+    for (size_t i = 1; i < cellStarts.size(); ++i) {
+        cellStarts[i] += cellStarts[i - 1];
+    }
+
+    /* Scatter in index order, so each cell's run stays ascending */
+    std::copy(cellStarts.begin(), cellStarts.end() - 1, cellFill.begin());
+    for (size_t i = 0; i < _count; ++i) {
+        const std::uint32_t _slot = cellFill[entityCells[i]]++;
+        xs[_slot] = _xs[i];
+        ys[_slot] = _ys[i];
+        ids[_slot] = static_cast<std::uint32_t>(i);
+    }
+}
+
+void SpatialHash::query(const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits) const {
+    _hits.clear();
+    if (_rect.w <= 0 || _rect.h <= 0) {
+        return;
+    }
+
+    const SDL_Rect _bounds = calc_bounds(_rect, tileSize);
+    const int _firstColumn = calc_cell_column(_bounds.x + 1);
+    const int _lastColumn = calc_cell_column(_bounds.x + _bounds.w - 1);
+    const int _firstRow = calc_cell_row(_bounds.y + 1);
+    const int _lastRow = calc_cell_row(_bounds.y + _bounds.h - 1);
+    for (int _row = _firstRow; _row <= _lastRow; ++_row) {
+        scan_run(xs.data(), ys.data(), ids.data(), cellStarts[_row * numCellCols + _firstColumn], cellStarts[_row * numCellCols + _lastColumn + 1], _bounds, _hits);
+    }
+
+    /* Runs from different rows of cells interleave */
+    if (_firstRow != _lastRow || _firstColumn != _lastColumn) {
+        std::sort(_hits.begin(), _hits.end());
+    }
+}
+
+void SpatialHash::scan_all(std::span<const int> _xs, std::span<const int> _ys, int _tileSize, const SDL_Rect& _rect, std::vector<std::uint32_t>& _hits) {
+    _hits.clear();
+    if (_rect.w <= 0 || _rect.h <= 0) {
+        return;
+    }
+
+    scan_run(_xs.data(), _ys.data(), nullptr, 0, _xs.size(), calc_bounds(_rect, _tileSize), _hits);
+}
@@ -0,0 +1,182 @@
+#include "textrenderer.hpp"
+#include "embeddedfont.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+TextRenderer::TextRenderer(
+    SDL_Renderer* _renderer,
+    TTF_Font* _font
+) :
+    renderer(_renderer),
+    font(_font),
+    lineHeight(init_line_height()),
+    atlasSize({0, 0}),
+    glyphs(),
+    atlas(init_atlas())
+{}
+
+int TextRenderer::init_line_height() const {
+    /* Embedded glyphs get a blank row above and below */
+    return font != nullptr ? TTF_FontHeight(font) : (embeddedGlyphHeight + 2) * embeddedScale;
+}
+
+SDL_Surface* TextRenderer::render_glyph(char _ch, int& _advance) const {
+    if (font == nullptr) {
+        return render_embedded_glyph(_ch, _advance);
+    }
+
+    SDL_Surface* _surface = TTF_RenderGlyph_Solid(font, static_cast<Uint16>(_ch), {255, 255, 255, SDL_ALPHA_OPAQUE});
+    if (_surface == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_RenderGlyph_Solid() failed: %s", TTF_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    if (TTF_GlyphMetrics(font, static_cast<Uint16>(_ch), nullptr, nullptr, nullptr, nullptr, &_advance) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "TTF_GlyphMetrics() failed: %s", TTF_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    return _surface;
+}
+
+SDL_Surface* TextRenderer::render_embedded_glyph(char _ch, int& _advance) const {
+    /* One column of spacing to the right of each glyph */
+    _advance = (embeddedGlyphWidth + 1) * embeddedScale;
+    SDL_Surface* _surface = SDL_CreateRGBSurfaceWithFormat(0, _advance, lineHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (_surface == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_CreateRGBSurfaceWithFormat() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    const Uint32 _white = SDL_MapRGBA(_surface->format, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    const auto& _rows = embeddedGlyphs[_ch - firstGlyph];
+    for (int y = 0; y < embeddedGlyphHeight; ++y) {
+        for (int x = 0; x < embeddedGlyphWidth; ++x) {
+            if ((_rows[y] >> (embeddedGlyphWidth - 1 - x) & 1) == 0) {
+                continue;
+            }
+
+            const SDL_Rect _pixel = {x * embeddedScale, (y + 1) * embeddedScale, embeddedScale, embeddedScale};
+            if (SDL_FillRect(_surface, &_pixel, _white) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_FillRect() failed: %s", SDL_GetError());
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    return _surface;
+}
+
+SDL_Texture* TextRenderer::init_atlas() {
+    /* Rasterize every printable ASCII glyph, then pack them into one row */
+    std::array<SDL_Surface*, lastGlyph - firstGlyph + 1> _surfaces;
+    for (int i = 0; i < static_cast<int>(_surfaces.size()); ++i) {
+        int _advance;
+        _surfaces[i] = render_glyph(static_cast<char>(firstGlyph + i), _advance);
+
+        glyphs[i] = {{atlasSize.x, 0, _surfaces[i]->w, _surfaces[i]->h}, _advance};
+        atlasSize.x += _surfaces[i]->w;
+        atlasSize.y = std::max(atlasSize.y, _surfaces[i]->h);
+    }
+
+    SDL_Surface* _atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasSize.x, atlasSize.y, 32, SDL_PIXELFORMAT_RGBA32);
+    if (_atlasSurface == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_CreateRGBSurfaceWithFormat() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < static_cast<int>(_surfaces.size()); ++i) {
+        SDL_Rect _dest = glyphs[i].rect;
+        if (SDL_BlitSurface(_surfaces[i], nullptr, _atlasSurface, &_dest) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_BlitSurface() failed: %s", SDL_GetError());
+            exit(EXIT_FAILURE);
+        }
+        SDL_FreeSurface(_surfaces[i]);
+    }
+
+    SDL_Texture* _texture = SDL_CreateTextureFromSurface(renderer, _atlasSurface);
+    if (_texture == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_CreateTextureFromSurface() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+    SDL_FreeSurface(_atlasSurface);
+
+    if (SDL_SetTextureBlendMode(_texture, SDL_BLENDMODE_BLEND) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_SetTextureBlendMode() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+
+    return _texture;
+}
+
+TextRenderer::Label TextRenderer::make_label(SDL_Point _position, Align _align, SDL_Color _color) const {
+    return Label{"", _position, _align, _color, {_position.x, _position.y, 0, lineHeight}, {}, {}};
+}
+
+void TextRenderer::set_text(Label& _label, std::string_view _text) const {
+    if (_label.text == _text) {
+        return;
+    }
+
+    _label.text = _text;
+    build_quads(_label);
+}
+
+void TextRenderer::build_quads(Label& _label) const {
+    int _width = 0;
+    for (const char _ch : _label.text) {
+        const int _index = (_ch >= firstGlyph && _ch <= lastGlyph ? _ch : '?') - firstGlyph;
+        _width += glyphs[_index].advance;
+    }
+
+    const int _x = _label.align == Align::right ? _label.position.x - _width : _label.position.x;
+    _label.rect = {_x, _label.position.y, _width, lineHeight};
+
+    /* Reuses the label's storage, so refreshing a label of the same length allocates nothing */
+    _label.vertices.clear();
+    _label.indices.clear();
+    float _penX = static_cast<float>(_x);
+    const float _penY = static_cast<float>(_label.position.y);
+    for (const char _ch : _label.text) {
+        const Glyph& _glyph = glyphs[(_ch >= firstGlyph && _ch <= lastGlyph ? _ch : '?') - firstGlyph];
+        const float _u0 = static_cast<float>(_glyph.rect.x) / atlasSize.x;
+        const float _u1 = static_cast<float>(_glyph.rect.x + _glyph.rect.w) / atlasSize.x;
+        const float _v1 = static_cast<float>(_glyph.rect.h) / atlasSize.y;
+        const int _base = static_cast<int>(_label.vertices.size());
+
+        _label.vertices.push_back({{_penX, _penY}, _label.color, {_u0, 0.0f}});
+        _label.vertices.push_back({{_penX + _glyph.rect.w, _penY}, _label.color, {_u1, 0.0f}});
+        _label.vertices.push_back({{_penX + _glyph.rect.w, _penY + _glyph.rect.h}, _label.color, {_u1, _v1}});
+        _label.vertices.push_back({{_penX, _penY + _glyph.rect.h}, _label.color, {_u0, _v1}});
+        for (const int _corner : {0, 1, 2, 0, 2, 3}) {
+            _label.indices.push_back(_base + _corner);
+        }
+
+        _penX += _glyph.advance;
+    }
+}
+
+void TextRenderer::draw(const Label& _label) const {
+    if (_label.indices.empty()) {
+        return;
+    }
+
+    if (SDL_RenderGeometry(renderer, atlas, _label.vertices.data(), static_cast<int>(_label.vertices.size()), _label.indices.data(), static_cast<int>(_label.indices.size())) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "SDL_RenderGeometry() failed: %s", SDL_GetError());
+        exit(EXIT_FAILURE);
+    }
+}
+
+int TextRenderer::get_line_height() const {
+    return lineHeight;
+}
+
+void TextRenderer::shutdown() {
+    /* The font belongs to the asset manager */
+    font = nullptr;
+
+    if (atlas != nullptr) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+}
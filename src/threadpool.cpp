@@ -0,0 +1,120 @@
+#include "threadpool.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int _numThreads) :
+    numThreads(std::max(1u, _numThreads)),
+    shares(std::make_unique<Share[]>(numThreads)),
+    threads(),
+    mutex(),
+    wake(),
+    finished(),
+    task(nullptr),
+    count(0),
+    chunkSize(0),
+    generation(0),
+    numBusy(0),
+    stopping(false)
+{
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(&ThreadPool::work_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> _lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& _thread : threads) {
+        _thread.join();
+    }
+}
+
+void ThreadPool::run(size_t _count, size_t _chunkSize, const Task& _task) {
+    const size_t _numChunks = (_count + _chunkSize - 1) / _chunkSize;
+    if (threads.empty() || _numChunks <= 1) {
+        for (size_t _first = 0; _first < _count; _first += _chunkSize) {
+            _task(_first, std::min(_first + _chunkSize, _count));
+        }
+        return;
+    }
+
+    for (unsigned int i = 0; i < numThreads; ++i) {
+        const std::uint64_t _first = _numChunks * i / numThreads;
+        const std::uint64_t _last = _numChunks * (i + 1) / numThreads;
+        shares[i].chunks.store(_last << 32 | _first, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> _lock(mutex);
+        task = &_task;
+        count = _count;
+        chunkSize = _chunkSize;
+        numBusy = static_cast<unsigned int>(threads.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    /* Every worker has to be done with this run before the next can deal new shares */
+    std::unique_lock<std::mutex> _lock(mutex);
+    finished.wait(_lock, [this] { return numBusy == 0; });
+    task = nullptr;
+}
+
+void ThreadPool::work_loop(unsigned int _thread) {
+    std::uint64_t _seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> _lock(mutex);
+            wake.wait(_lock, [&] { return stopping || generation != _seen; });
+            if (stopping) {
+                return;
+            }
+            _seen = generation;
+        }
+
+        work(_thread);
+
+        std::lock_guard<std::mutex> _lock(mutex);
+        if (--numBusy == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::work(unsigned int _thread) {
+    PROFILE_ZONE("ThreadPool::work");
+    size_t _chunk;
+    while (take(_thread, _chunk)) {
+        const size_t _first = _chunk * chunkSize;
+        (*task)(_first, std::min(_first + chunkSize, count));
+    }
+}
+
+/* Shares are only dealt at the start of a run, so once every one is empty
+ * there is nothing left to take */
+bool ThreadPool::take(unsigned int _thread, size_t& _chunk) {
+    for (unsigned int i = 0; i < numThreads; ++i) {
+        const bool _own = i == 0;
+        Share& _share = shares[(_thread + i) % numThreads];
+        std::uint64_t _chunks = _share.chunks.load(std::memory_order_relaxed);
+        while (true) {
+            const std::uint64_t _first = _chunks & 0xffffffff;
+            const std::uint64_t _last = _chunks >> 32;
+            if (_first >= _last) {
+                break;
+            }
+
+            /* The owner takes from the front and thieves from the back */
+            const std::uint64_t _taken = _own ? _chunks + 1 : _chunks - (std::uint64_t(1) << 32);
+            if (_share.chunks.compare_exchange_weak(_chunks, _taken, std::memory_order_relaxed)) {
+                _chunk = static_cast<size_t>(_own ? _first : _last - 1);
+                return true;
+            }
+        }
+    }
+    return false;
+}